@@ -17,13 +17,17 @@
 #ifndef DATA_CONSUMER_H
 #define DATA_CONSUMER_H
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <thread>
 #include <memory>
 #include <functional>
+#include <vector>
 #include "framework/streaming_pipeline.h"
 #include "framework/data_object.h"
 #include "utils/logger.h"
+#include "utils/thread_priority.h"
 #include "utils/unified_allocator.h"
 
 namespace GryFlux
@@ -39,6 +43,8 @@ namespace GryFlux
         std::atomic<bool> &running;
         BaseUnifiedAllocator *allocator;
         std::thread consumer_thread;
+        ThreadPolicy thread_policy;
+        std::atomic<bool> thread_policy_granted{true};
 
     public:
         /**
@@ -57,6 +63,23 @@ namespace GryFlux
             stop();
         }
 
+        /**
+         * 设置消费者线程的调度策略，需在start之前调用
+         * @param policy 实时优先级、nice值与mlockall
+         */
+        void setThreadPolicy(const ThreadPolicy &policy)
+        {
+            thread_policy = policy;
+        }
+
+        /**
+         * 消费者线程是否获得了请求的调度策略，线程启动前或没有请求时返回true
+         */
+        bool isThreadPolicyGranted() const
+        {
+            return thread_policy_granted.load();
+        }
+
         /**
          * 启动消费者线程
          * @return 成功返回true，失败返回false
@@ -65,7 +88,10 @@ namespace GryFlux
         {
             try
             {
-                consumer_thread = std::thread(&DataConsumer::run, this);
+                consumer_thread = std::thread([this]()
+                                              {
+                                                  thread_policy_granted = applyThreadPolicy(thread_policy, "Consumer").granted();
+                                                  run(); });
                 return true;
             }
             catch (const std::exception &e)
@@ -105,23 +131,83 @@ namespace GryFlux
         virtual void run() = 0;
 
         /**
-         * 从管道获取数据
+         * 从管道获取数据，阻塞直到有输出、超时或输出关闭
          * @param data 接收数据的指针引用
+         * @param timeout 最长等待时间，超时后返回以便重新检查运行状态
          * @return 成功返回true，失败返回false
          */
-        bool getData(std::shared_ptr<DataObject> &data)
+        bool getData(std::shared_ptr<DataObject> &data,
+                     std::chrono::milliseconds timeout = std::chrono::milliseconds(100))
         {
-            return pipeline.tryGetOutput(data);
+            return pipeline.waitForOutput(data, timeout);
         }
 
         /**
-         * 检查是否应该继续运行
+         * 从管道批量获取已就绪的数据，阻塞直到至少有一个输出、超时或输出关闭
+         * @param data 接收数据的数组
+         * @param maxCount 最多获取的数量
+         * @param timeout 最长等待时间
+         * @return 实际获取的数量
+         */
+        size_t getData(std::shared_ptr<DataObject> *data, size_t maxCount,
+                       std::chrono::milliseconds timeout = std::chrono::milliseconds(100))
+        {
+            return pipeline.waitForOutputBulk(data, maxCount, timeout);
+        }
+
+        /**
+         * 检查是否应该继续运行：输出关闭且取空后即结束
          * @return 应该继续运行返回true，否则返回false
          */
         bool shouldContinue()
         {
-            return running.load() || !pipeline.outputEmpty() || pipeline.isOutputActive();
+            return !pipeline.outputEmpty() || pipeline.isOutputActive() ||
+                   (running.load() && !pipeline.isOutputClosed());
+        }
+    };
+
+    /**
+     * 批量数据消费者基类 - 每次取出输出队列中所有已就绪的结果（最多maxBatchSize个），
+     * 一次交给consumeBatch处理，适合需要合并写出大量小结果的输出端
+     */
+    class BatchDataConsumer : public DataConsumer
+    {
+    public:
+        /**
+         * 构造函数
+         * @param maxBatchSize 每批最多的结果数量
+         */
+        BatchDataConsumer(StreamingPipeline &pipeline, std::atomic<bool> &running, BaseUnifiedAllocator *allocator,
+                          size_t maxBatchSize = 32)
+            : DataConsumer(pipeline, running, allocator), batch_(std::max<size_t>(maxBatchSize, 1)) {}
+
+    protected:
+        /**
+         * 纯虚函数 - 批量消费逻辑，需要被子类实现
+         * @param results 已就绪的结果，按输出顺序排列
+         * @param count 结果数量
+         */
+        virtual void consumeBatch(const std::shared_ptr<DataObject> *results, size_t count) = 0;
+
+        /**
+         * 消费循环：子类重写run()时可调用本实现
+         */
+        void run() override
+        {
+            while (shouldContinue())
+            {
+                size_t count = getData(batch_.data(), batch_.size());
+                if (count > 0)
+                {
+                    consumeBatch(batch_.data(), count);
+                    // 处理完立即释放本批结果
+                    std::fill_n(batch_.begin(), count, nullptr);
+                }
+            }
         }
+
+    private:
+        std::vector<std::shared_ptr<DataObject>> batch_;
     };
 
 } // namespace GryFlux
@@ -16,11 +16,14 @@
  *************************************************************************************************************************/
 #pragma once
 
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <typeinfo>
 #include <typeindex>
+#include <utility>
 
 namespace GryFlux
 {
@@ -29,6 +32,9 @@ namespace GryFlux
     class DataObject
     {
     public:
+        // 截止时间使用单调时钟，不受系统时间调整影响
+        using Clock = std::chrono::steady_clock;
+
         virtual ~DataObject() = default;
 
         // 获取数据对象的类型信息
@@ -63,6 +69,49 @@ namespace GryFlux
         {
             return dynamic_cast<const T *>(this) != nullptr;
         }
+
+        // 帧序号：由StreamingPipeline::addInput分配，输出结果带有对应输入帧的序号
+        uint64_t getSequence() const { return sequence_; }
+        void setSequence(uint64_t sequence) { sequence_ = sequence; }
+
+        // 截止时间：超过后该帧的结果不再有价值，管道可以丢弃该帧；默认没有截止时间
+        Clock::time_point getDeadline() const { return deadline_; }
+        void setDeadline(Clock::time_point deadline) { deadline_ = deadline; }
+        bool hasDeadline() const { return deadline_ != Clock::time_point::max(); }
+
+    private:
+        uint64_t sequence_ = 0;
+        Clock::time_point deadline_ = Clock::time_point::max();
+    };
+
+    // 条件输出：处理函数返回它代替正常结果，表示本帧在该节点被跳过、没有结果或出错。
+    // 下游节点按输入边的条件（见EdgeCondition）被剪枝或转入替代分支，不会被调度执行
+    class TaskOutcome : public DataObject
+    {
+    public:
+        enum class Kind
+        {
+            Skip,  // 本帧不需要后续处理
+            Empty, // 正常执行但没有结果（如未检测到目标）
+            Error  // 处理失败
+        };
+
+        explicit TaskOutcome(Kind kind, std::string message = std::string())
+            : kind_(kind), message_(std::move(message)) {}
+
+        static std::shared_ptr<TaskOutcome> skip() { return std::make_shared<TaskOutcome>(Kind::Skip); }
+        static std::shared_ptr<TaskOutcome> empty() { return std::make_shared<TaskOutcome>(Kind::Empty); }
+        static std::shared_ptr<TaskOutcome> error(std::string message = std::string())
+        {
+            return std::make_shared<TaskOutcome>(Kind::Error, std::move(message));
+        }
+
+        Kind getKind() const { return kind_; }
+        const std::string &getMessage() const { return message_; }
+
+    private:
+        Kind kind_;
+        std::string message_;
     };
 
 } // namespace GryFlux
\ No newline at end of file
@@ -23,6 +23,7 @@
 #include "framework/streaming_pipeline.h"
 #include "framework/data_object.h"
 #include "utils/logger.h"
+#include "utils/thread_priority.h"
 #include "utils/unified_allocator.h"
 
 namespace GryFlux
@@ -38,6 +39,8 @@ namespace GryFlux
         std::atomic<bool> &running;
         BaseUnifiedAllocator *allocator;
         std::thread producer_thread;
+        ThreadPolicy thread_policy;
+        std::atomic<bool> thread_policy_granted{true};
 
     public:
         /**
@@ -56,6 +59,23 @@ namespace GryFlux
             stop();
         }
 
+        /**
+         * 设置生产者线程的调度策略，需在start之前调用
+         * @param policy 实时优先级、nice值与mlockall
+         */
+        void setThreadPolicy(const ThreadPolicy &policy)
+        {
+            thread_policy = policy;
+        }
+
+        /**
+         * 生产者线程是否获得了请求的调度策略，线程启动前或没有请求时返回true
+         */
+        bool isThreadPolicyGranted() const
+        {
+            return thread_policy_granted.load();
+        }
+
         /**
          * 启动生产者线程
          * @return 成功返回true，失败返回false
@@ -64,7 +84,10 @@ namespace GryFlux
         {
             try
             {
-                producer_thread = std::thread(&DataProducer::run, this);
+                producer_thread = std::thread([this]()
+                                              {
+                                                  thread_policy_granted = applyThreadPolicy(thread_policy, "Producer").granted();
+                                                  run(); });
                 return true;
             }
             catch (const std::exception &e)
@@ -0,0 +1,136 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "framework/data_object.h"
+#include "framework/suspendable_task.h"
+
+namespace GryFlux
+{
+
+    // 动态批处理：把多个在途帧对同一任务的调用合并成一次批量调用。
+    // 调用进入正在接收的批次后即被挂起，不占用调用线程；批次凑满或第一个调用等待超过maxWait后封闭，
+    // 作为一个批处理任务提交到执行器，结果再分发回各调用所属的执行器继续执行。
+    // 批处理函数串行执行，执行期间封闭的批次依次排队，设备越忙批次越大。
+    // 管道启动时通过addCallers登记最多有多少帧会同时调用，批次人数达到该值时已不会再有帧加入，立即封闭
+    class DynamicBatcher : public SuspendableTask
+    {
+    public:
+        // 批处理函数：输入为每帧的输入列表，返回与之一一对应的结果
+        using BatchFunction = std::function<std::vector<std::shared_ptr<DataObject>>(const std::vector<Inputs> &)>;
+
+        struct Stats
+        {
+            size_t calls = 0;         // 已执行批次中的调用次数（帧数）
+            size_t batches = 0;       // 批处理函数执行次数
+            size_t fullBatches = 0;   // 凑满maxBatchSize的批次数
+            double meanBatchSize = 0; // 平均批大小
+            double hitRate = 0;       // 命中率：凑满批次（maxBatchSize与同时调用数中较小者）的比例，过低说明maxWait偏小
+        };
+
+        DynamicBatcher(BatchFunction func, size_t maxBatchSize, std::chrono::microseconds maxWait);
+        ~DynamicBatcher() override;
+
+        DynamicBatcher(const DynamicBatcher &) = delete;
+        DynamicBatcher &operator=(const DynamicBatcher &) = delete;
+
+        // 提交一帧的输入并阻塞到所在批次执行完成；批处理函数抛出的异常在每个调用方重新抛出
+        std::shared_ptr<DataObject> process(const Inputs &inputs) override;
+
+        // 挂起调用直到所在批次执行完成，总是返回false；批次在封闭它的调用所属的执行器上执行
+        bool invoke(const Inputs &inputs, std::shared_ptr<DataObject> &result,
+                    Executor &executor, uint64_t priority, Completion done) override;
+
+        // 登记或注销同时调用的帧数（如管道的在途帧数或阶段的工作线程数），没有登记时不限制（默认）
+        void addCallers(size_t count) override;
+        void removeCallers(size_t count) override;
+
+        Stats getStats() const;
+
+        size_t getMaxBatchSize() const { return maxBatchSize_; }
+        std::chrono::microseconds getMaxWait() const { return maxWait_; }
+
+    private:
+        // 挂起的调用；executor为空表示同步调用，完成回调直接在执行批次的线程上调用
+        struct Call
+        {
+            Inputs inputs;
+            Completion done;
+            Executor *executor;
+            uint64_t priority;
+        };
+
+        struct Batch
+        {
+            std::vector<Call> calls;
+            std::chrono::steady_clock::time_point deadline; // 超过后批次不再等待新的调用
+            Executor *executor = nullptr;                   // 执行批处理函数的执行器，为空时在封闭批次的线程上执行
+            uint64_t priority = 0;                          // 各调用中最高的优先级
+            std::vector<std::shared_ptr<DataObject>> results;
+            std::exception_ptr error;
+        };
+
+        // 加入正在接收的批次，批次凑满时封闭；调用时需持有mutex_
+        void enqueueCall(Call call);
+        // 封闭正在接收的批次，放入待执行队列；调用时需持有mutex_
+        void closeOpenBatch();
+        // 没有批次在执行时取出下一个待执行的批次，否则返回空；调用时需持有mutex_
+        std::shared_ptr<Batch> takeReadyBatch();
+        // 在批次的执行器上执行批次，执行器为空时在当前线程执行
+        void submitBatch(std::shared_ptr<Batch> batch);
+        // 依次执行batch及之后排队的批次；current为当前线程所属的执行器，不属于任何执行器时为空
+        void runBatches(std::shared_ptr<Batch> batch, Executor *current);
+        void runBatch(Batch &batch);
+        // 把结果分发回各调用所属的执行器；allowInline时当前执行器上的一个调用直接在当前线程继续
+        void completeBatch(const std::shared_ptr<Batch> &batch, Executor *current, bool allowInline);
+        void completeCall(const Batch &batch, size_t index);
+        // 封闭等待超过maxWait的批次并提交执行
+        void timerLoop();
+
+        // 批次凑满的人数：maxBatchSize与同时调用数中较小者；调用时需持有mutex_
+        size_t batchTarget() const;
+
+        BatchFunction func_;
+        size_t maxBatchSize_;
+        std::chrono::microseconds maxWait_;
+
+        mutable std::mutex mutex_;
+        std::condition_variable timerCondition_;
+        std::shared_ptr<Batch> openBatch_;              // 正在接收调用的批次
+        std::deque<std::shared_ptr<Batch>> readyBatches_; // 已封闭、等待执行的批次
+        bool running_ = false;                          // 是否有批次正在执行，批处理函数串行执行
+        bool stopping_ = false;
+        size_t maxCallers_ = 0;
+        std::thread timer_; // 批次等待超时的计时线程
+
+        size_t calls_ = 0;
+        size_t batches_ = 0;
+        size_t fullBatches_ = 0;
+    };
+
+} // namespace GryFlux
@@ -0,0 +1,56 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace GryFlux
+{
+
+    // 当前线程正在调用的处理函数中，调度器已移交独占所有权的输入，按输入位置记录为位掩码（只记录前64个输入）。
+    // 调用处理函数的一方（计算图节点、阶段工作线程）在调用期间设置，ProcessingTask::takeInput据此决定是否拷贝
+    class ExclusiveInputs
+    {
+    public:
+        static uint64_t bit(size_t position) { return position < 64 ? uint64_t(1) << position : 0; }
+        static bool contains(size_t position) { return (current() & bit(position)) != 0; }
+        static uint64_t current() { return mask(); }
+
+        // 在作用域内设置当前线程的独占输入，离开时恢复
+        class Scope
+        {
+        public:
+            explicit Scope(uint64_t inputs) : previous_(mask()) { mask() = inputs; }
+            ~Scope() { mask() = previous_; }
+
+            Scope(const Scope &) = delete;
+            Scope &operator=(const Scope &) = delete;
+
+        private:
+            uint64_t previous_;
+        };
+
+    private:
+        static uint64_t &mask()
+        {
+            thread_local uint64_t inputs = 0;
+            return inputs;
+        }
+    };
+
+} // namespace GryFlux
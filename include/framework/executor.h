@@ -0,0 +1,105 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <type_traits>
+#include "framework/inplace_task.h"
+#include "utils/cpu_topology.h"
+#include "utils/thread_priority.h"
+
+namespace GryFlux
+{
+
+    // 线程池实现类型
+    enum class ThreadPoolType
+    {
+        SharedQueue, // 单一共享任务队列（ThreadPool）
+        WorkStealing // 每线程本地双端队列 + 随机窃取（WorkStealingThreadPool）
+    };
+
+    // 执行器接口，TaskScheduler 通过它提交任务，而不关心具体的线程池实现
+    class Executor
+    {
+    public:
+        virtual ~Executor() = default;
+
+        // 提交任务到执行器，通过 future 获取返回值。
+        // 以提交时刻为优先级，与调度器节点的最晚开始时刻在同一时间轴上比较，不会排在所有节点之后
+        template <class F>
+        auto enqueue(F &&f) -> std::future<typename std::result_of<F()>::type>
+        {
+            using return_type = typename std::result_of<F()>::type;
+
+            auto task = std::make_shared<std::packaged_task<return_type()>>(std::forward<F>(f));
+            std::future<return_type> res = task->get_future();
+            post([task]()
+                 { (*task)(); },
+                 currentPriority());
+            return res;
+        }
+
+        // 提交无需返回值的任务：不创建 future，可调用对象直接存放在复用的任务槽中，
+        // 预热后每个任务没有堆分配。调度器提交节点时使用此接口。
+        // priority 数值越小越先执行（如截止时间），未指定优先级的任务排在所有带优先级的任务之后
+        template <class F>
+        void dispatch(F &&f, uint64_t priority = TaskQueue::kNoPriority)
+        {
+            post(InplaceTask(std::forward<F>(f)), priority);
+        }
+
+        // 获取工作线程数量
+        virtual size_t getThreadCount() const = 0;
+
+        // 获取当前待处理任务数量
+        virtual size_t getTaskCount() const = 0;
+
+        // 已启动的工作线程是否都获得了请求的调度策略，没有请求时为true
+        virtual bool isThreadPolicyGranted() const { return true; }
+
+        // 当前时刻对应的优先级（steady_clock纳秒数），与调度器使用的参考时刻一致
+        static uint64_t currentPriority()
+        {
+            return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch() /
+                                         std::chrono::nanoseconds(1));
+        }
+
+    protected:
+        // 将任务放入具体实现的队列，执行器已停止时抛出 std::runtime_error
+        virtual void post(InplaceTask task, uint64_t priority) = 0;
+    };
+
+    // 按类型创建线程池，numThreads 为 0 时使用 affinity 绑定的 CPU 数量（不绑定时为硬件线程数）；affinity 指定工作线程绑定的 CPU，
+    // policy 指定工作线程的调度策略
+    std::shared_ptr<Executor> createThreadPool(size_t numThreads, ThreadPoolType type = ThreadPoolType::SharedQueue,
+                                               const CpuAffinity &affinity = CpuAffinity::any(),
+                                               const ThreadPolicy &policy = ThreadPolicy());
+
+    // I/O线程池默认每个核心的线程数：I/O任务大部分时间阻塞在系统调用上，线程数按核心数超额配置
+    constexpr size_t kIoThreadsPerCore = 4;
+
+    // 创建执行TaskKind::Io节点的线程池，使用共享队列；numThreads 为 0 时使用 affinity 绑定的 CPU 数量
+    // （不绑定时为硬件线程数）× kIoThreadsPerCore。affinity 与 policy 的含义同 createThreadPool，
+    // 例如把I/O线程绑定到小核、调低其优先级，让计算线程独占大核
+    std::shared_ptr<Executor> createIoThreadPool(size_t numThreads = 0, const CpuAffinity &affinity = CpuAffinity::any(),
+                                                 const ThreadPolicy &policy = ThreadPolicy());
+
+} // namespace GryFlux
@@ -0,0 +1,79 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "framework/task_node.h"
+
+namespace GryFlux
+{
+
+    // 计算图模板：拓扑结构、拓扑序与任务绑定只构建和校验一次，
+    // 每个在途帧槽位据此实例化一次计算图，之后每帧只需绑定输入并重置节点状态
+    class GraphTemplate
+    {
+    public:
+        using ProcessFunction = MultiInputTaskNode::ProcessFunction;
+
+        // 模板中的节点描述
+        struct NodeSpec
+        {
+            std::string id;
+            ProcessFunction func;       // 输入节点为空
+            std::vector<size_t> inputs; // 输入节点在模板中的序号
+            std::vector<EdgeCondition> conditions; // 与inputs一一对应的输入边条件
+            TaskKind kind = TaskKind::Compute;
+        };
+
+        GraphTemplate() = default;
+
+        // 添加输入节点，模板有且只有一个输入节点，每帧的输入数据绑定到该节点
+        void addInput(const std::string &id);
+
+        // 添加处理节点，inputs中的节点必须已经添加，因此模板天然无环；
+        // conditions与inputs一一对应，为空时所有输入边都为OnValue
+        void addTask(const std::string &id, ProcessFunction func, const std::vector<std::string> &inputs,
+                     const std::vector<EdgeCondition> &conditions = {});
+
+        // 设置已添加节点的任务类型，I/O节点在调度器设置了I/O执行器时提交到该执行器
+        void setTaskKind(const std::string &id, TaskKind kind);
+
+        // 校验并冻结模板，裁剪输出节点不可达的节点；模板非法时抛出std::runtime_error
+        void compile(const std::string &outputId);
+
+        bool isCompiled() const { return compiled_; }
+        const std::string &getInputId() const { return nodes_[inputIndex_].id; }
+        const std::string &getOutputId() const { return outputId_; }
+
+        // 按拓扑序排列的节点（compile之后只包含输出节点可达的节点）
+        const std::vector<NodeSpec> &getNodes() const { return nodes_; }
+
+    private:
+        void checkMutable() const;
+
+        std::vector<NodeSpec> nodes_;
+        std::unordered_map<std::string, size_t> indices_;
+        size_t inputIndex_ = 0;
+        bool hasInput_ = false;
+        std::string outputId_;
+        bool compiled_ = false;
+    };
+
+} // namespace GryFlux
@@ -0,0 +1,285 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace GryFlux
+{
+
+    // 固定容量的小缓冲区可调用对象：可调用对象直接构造在内部缓冲区中，
+    // 不像 std::function 那样可能在堆上分配。超出容量的可调用对象在编译期报错
+    class InplaceTask
+    {
+    public:
+        static constexpr size_t kCapacity = 64;
+
+        InplaceTask() noexcept = default;
+
+        template <class F, class = typename std::enable_if<
+                               !std::is_same<typename std::decay<F>::type, InplaceTask>::value>::type>
+        InplaceTask(F &&f)
+        {
+            using Fn = typename std::decay<F>::type;
+            static_assert(sizeof(Fn) <= kCapacity, "callable too large for InplaceTask");
+            static_assert(alignof(Fn) <= alignof(std::max_align_t), "callable over-aligned for InplaceTask");
+            static_assert(std::is_nothrow_move_constructible<Fn>::value,
+                          "callable stored in InplaceTask must be nothrow move constructible");
+
+            new (&storage_) Fn(std::forward<F>(f));
+            ops_ = &OpsFor<Fn>::table;
+        }
+
+        InplaceTask(InplaceTask &&other) noexcept
+        {
+            moveFrom(other);
+        }
+
+        InplaceTask &operator=(InplaceTask &&other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                moveFrom(other);
+            }
+            return *this;
+        }
+
+        InplaceTask(const InplaceTask &) = delete;
+        InplaceTask &operator=(const InplaceTask &) = delete;
+
+        ~InplaceTask()
+        {
+            reset();
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return ops_ != nullptr;
+        }
+
+        void operator()()
+        {
+            ops_->invoke(&storage_);
+        }
+
+        // 销毁内部的可调用对象，槽位可再次使用
+        void reset() noexcept
+        {
+            if (ops_)
+            {
+                ops_->destroy(&storage_);
+                ops_ = nullptr;
+            }
+        }
+
+    private:
+        struct Ops
+        {
+            void (*invoke)(void *);
+            void (*move)(void *dst, void *src);
+            void (*destroy)(void *);
+        };
+
+        template <class Fn>
+        struct OpsFor
+        {
+            static void invoke(void *p)
+            {
+                (*static_cast<Fn *>(p))();
+            }
+            static void move(void *dst, void *src)
+            {
+                new (dst) Fn(std::move(*static_cast<Fn *>(src)));
+                static_cast<Fn *>(src)->~Fn();
+            }
+            static void destroy(void *p)
+            {
+                static_cast<Fn *>(p)->~Fn();
+            }
+            static constexpr Ops table{&invoke, &move, &destroy};
+        };
+
+        void moveFrom(InplaceTask &other) noexcept
+        {
+            if (other.ops_)
+            {
+                other.ops_->move(&storage_, &other.storage_);
+                ops_ = other.ops_;
+                other.ops_ = nullptr;
+            }
+        }
+
+        alignas(std::max_align_t) unsigned char storage_[kCapacity];
+        const Ops *ops_ = nullptr;
+    };
+
+    // InplaceTask 的环形队列：任务槽位在出队后原地复用，容量只增不减，
+    // 预热到峰值深度后入队出队都不再分配内存。本身不加锁，由调用方保护
+    class TaskRing
+    {
+    public:
+        explicit TaskRing(size_t initialCapacity = 64)
+        {
+            size_t capacity = 1;
+            while (capacity < initialCapacity)
+            {
+                capacity <<= 1;
+            }
+            slots_.resize(capacity);
+        }
+
+        bool empty() const
+        {
+            return size_ == 0;
+        }
+
+        size_t size() const
+        {
+            return size_;
+        }
+
+        void push_back(InplaceTask &&task)
+        {
+            if (size_ == slots_.size())
+            {
+                grow();
+            }
+            slots_[(head_ + size_) & (slots_.size() - 1)] = std::move(task);
+            ++size_;
+        }
+
+        // 取出最早入队的任务
+        void pop_front(InplaceTask &task)
+        {
+            task = std::move(slots_[head_]);
+            head_ = (head_ + 1) & (slots_.size() - 1);
+            --size_;
+        }
+
+        // 取出最后入队的任务
+        void pop_back(InplaceTask &task)
+        {
+            --size_;
+            task = std::move(slots_[(head_ + size_) & (slots_.size() - 1)]);
+        }
+
+    private:
+        // 容量翻倍，保持容量为2的幂以便用掩码取模
+        void grow()
+        {
+            std::vector<InplaceTask> slots(slots_.size() * 2);
+            for (size_t i = 0; i < size_; ++i)
+            {
+                slots[i] = std::move(slots_[(head_ + i) & (slots_.size() - 1)]);
+            }
+            slots_.swap(slots);
+            head_ = 0;
+        }
+
+        std::vector<InplaceTask> slots_;
+        size_t head_ = 0;
+        size_t size_ = 0;
+    };
+
+    // 带优先级的任务队列：指定了优先级的任务放入最小堆（数值越小越先执行，同优先级先进先出），
+    // 未指定优先级的任务放入TaskRing，只有堆为空时才会取出。两者的存储都只增不减
+    class TaskQueue
+    {
+    public:
+        static constexpr uint64_t kNoPriority = UINT64_MAX;
+
+        bool empty() const
+        {
+            return heap_.empty() && ring_.empty();
+        }
+
+        size_t size() const
+        {
+            return heap_.size() + ring_.size();
+        }
+
+        void push(InplaceTask &&task, uint64_t priority)
+        {
+            if (priority == kNoPriority)
+            {
+                ring_.push_back(std::move(task));
+                return;
+            }
+            heap_.push_back({priority, order_++, std::move(task)});
+            std::push_heap(heap_.begin(), heap_.end(), Later());
+        }
+
+        // 取出优先级最高的任务，无优先级任务按最早入队的顺序
+        void pop_front(InplaceTask &task)
+        {
+            if (!popHeap(task))
+            {
+                ring_.pop_front(task);
+            }
+        }
+
+        // 取出优先级最高的任务，无优先级任务按最后入队的顺序
+        void pop_back(InplaceTask &task)
+        {
+            if (!popHeap(task))
+            {
+                ring_.pop_back(task);
+            }
+        }
+
+    private:
+        struct Entry
+        {
+            uint64_t priority;
+            uint64_t order;
+            InplaceTask task;
+        };
+
+        // 堆顶为优先级数值最小、入队最早的任务
+        struct Later
+        {
+            bool operator()(const Entry &a, const Entry &b) const
+            {
+                return a.priority != b.priority ? a.priority > b.priority : a.order > b.order;
+            }
+        };
+
+        bool popHeap(InplaceTask &task)
+        {
+            if (heap_.empty())
+            {
+                return false;
+            }
+            std::pop_heap(heap_.begin(), heap_.end(), Later());
+            task = std::move(heap_.back().task);
+            heap_.pop_back();
+            return true;
+        }
+
+        TaskRing ring_;
+        std::vector<Entry> heap_;
+        uint64_t order_ = 0;
+    };
+
+} // namespace GryFlux
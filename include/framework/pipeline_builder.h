@@ -22,6 +22,7 @@
 #include <functional>
 #include "framework/task_scheduler.h"
 #include "framework/task_node.h"
+#include "framework/graph_template.h"
 #include "framework/data_object.h"
 
 namespace GryFlux
@@ -31,21 +32,32 @@ namespace GryFlux
     class PipelineBuilder
     {
     public:
-        PipelineBuilder(size_t numThreads = 0);
+        PipelineBuilder(size_t numThreads = 0, ThreadPoolType poolType = ThreadPoolType::SharedQueue);
+
+        // 使用共享线程池构建，每个在途帧持有独立的计算图实例
+        explicit PipelineBuilder(std::shared_ptr<Executor> threadPool);
 
         // 添加输入数据源
         std::shared_ptr<TaskNode> addInput(const std::string &id, std::shared_ptr<DataObject> data);
 
-        // 添加多输入处理节点
+        // 添加多输入处理节点；conditions与inputs一一对应，为空时所有输入边都为OnValue
         std::shared_ptr<TaskNode> addTask(
             const std::string &id,
             std::function<std::shared_ptr<DataObject>(const std::vector<std::shared_ptr<DataObject>> &)> func,
-            const std::vector<std::shared_ptr<TaskNode>> &inputs);
+            const std::vector<std::shared_ptr<TaskNode>> &inputs,
+            const std::vector<EdgeCondition> &conditions = {});
 
         // 执行整个流水线，返回指定输出节点的结果
         std::shared_ptr<DataObject> execute(const std::string &outputId);
+        std::shared_ptr<DataObject> execute(TaskNode::TaskId outputId);
+
+        // 按已编译的计算图模板创建节点并冻结执行计划，每个图实例只需调用一次
+        void instantiate(const GraphTemplate &graph);
+
+        // 复用模板实例：重置所有节点状态并绑定新一帧的输入数据
+        void bindInput(std::shared_ptr<DataObject> data);
 
-        // 重置流水线，以便重用
+        // 重置流水线，以便重用；线程池、I/O执行器与执行时间估计保留
         void reset();
 
         // 设置是否启用性能分析
@@ -59,6 +71,7 @@ namespace GryFlux
 
     private:
         std::shared_ptr<TaskScheduler> scheduler_;
+        std::shared_ptr<InputNode> templateInput_; // 模板实例的输入节点
         bool profilingEnabled_ = false;
     };
 
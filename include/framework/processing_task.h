@@ -16,11 +16,21 @@
  *************************************************************************************************************************/
 #pragma once
 
+#include <chrono>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <vector>
 #include <functional>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 #include "data_object.h"
+#include "dynamic_batcher.h"
+#include "exclusive_inputs.h"
+#include "suspendable_task.h"
 
 namespace GryFlux
 {
@@ -42,6 +52,31 @@ namespace GryFlux
          */
         virtual std::shared_ptr<DataObject> process(const std::vector<std::shared_ptr<DataObject>> &inputs) = 0;
 
+        /**
+         * @brief 以可写方式取得第index个输入，用于原地修改输入并作为输出
+         * 调度器按未执行完的读取者计数确认本任务是该输入唯一剩余的读取者时会移交独占所有权，此时直接返回原对象；
+         * 否则（仍有其他节点读取该对象，或不是由调度器调用）返回一份拷贝，T需可拷贝构造
+         * @return 类型不符或下标越界时返回空
+         */
+        template <typename T>
+        static std::shared_ptr<T> takeInput(const std::vector<std::shared_ptr<DataObject>> &inputs, size_t index)
+        {
+            if (index >= inputs.size())
+            {
+                return nullptr;
+            }
+            auto input = std::dynamic_pointer_cast<T>(inputs[index]);
+            if (!input)
+            {
+                return nullptr;
+            }
+            if (ExclusiveInputs::contains(index))
+            {
+                return input;
+            }
+            return std::make_shared<T>(*input);
+        }
+
         /**
          * @brief 获取绑定到当前任务实例的函数对象
          * @return 处理函数
@@ -55,34 +90,184 @@ namespace GryFlux
             };
         }
     };
+    /**
+     * @brief 支持批处理的任务基类
+     * 通过TaskRegistry::registerBatchTask注册后，多个在途帧的调用会被合并为一次processBatch
+     */
+    class BatchProcessingTask : public ProcessingTask
+    {
+    public:
+        /**
+         * @brief 批量处理数据
+         * @param batch 每帧的输入数据对象列表
+         * @return 与batch一一对应的处理结果
+         */
+        virtual std::vector<std::shared_ptr<DataObject>> processBatch(
+            const std::vector<std::vector<std::shared_ptr<DataObject>>> &batch) = 0;
+
+        // 单帧调用等价于大小为1的批次
+        std::shared_ptr<DataObject> process(const std::vector<std::shared_ptr<DataObject>> &inputs) override
+        {
+            auto results = processBatch({inputs});
+            return results.empty() ? nullptr : results.front();
+        }
+    };
+
+    // 任务实例的并发策略
+    struct TaskConcurrency
+    {
+        enum class Mode
+        {
+            Serial,     // 单实例，同一时间只有一帧调用（默认，适合持有设备上下文的有状态任务）
+            Replicated, // 多个实例，每次调用租用一个空闲实例
+            Unlimited   // 单实例，可被任意多个线程同时调用（无状态任务）
+        };
+
+        Mode mode = Mode::Serial;
+        size_t replicas = 1;
+
+        static TaskConcurrency serial() { return {Mode::Serial, 1}; }
+        static TaskConcurrency replicated(size_t count) { return {Mode::Replicated, count > 0 ? count : 1}; }
+        static TaskConcurrency unlimited() { return {Mode::Unlimited, 1}; }
+    };
+
+    /**
+     * @brief 同一任务ID的实例池
+     * 按并发策略把实例租给调用方。没有空闲实例时，调度器提交的调用被挂起并排队，
+     * 实例归还时直接转交给最早挂起的调用，在其执行器上继续执行，不占用等待中的工作线程
+     */
+    class TaskInstancePool : public SuspendableTask, public std::enable_shared_from_this<TaskInstancePool>
+    {
+    public:
+        TaskInstancePool(std::vector<std::shared_ptr<ProcessingTask>> instances, TaskConcurrency concurrency);
+
+        // 阻塞调用，没有空闲实例时在当前线程等待
+        std::shared_ptr<DataObject> process(const Inputs &inputs) override;
+
+        bool invoke(const Inputs &inputs, std::shared_ptr<DataObject> &result,
+                    Executor &executor, uint64_t priority, Completion done) override;
+
+        const TaskConcurrency &getConcurrency() const { return concurrency_; }
+
+    private:
+        // 排队等待实例的调用，参数为转交给它的实例序号
+        using Grant = std::function<void(size_t index)>;
+
+        // 取出一个空闲实例；没有空闲实例或已有调用在排队时把grant加入队尾并返回false
+        bool acquire(size_t &index, Grant grant);
+        // 归还实例：有排队的调用时直接转交给最早的一个，否则放回空闲列表
+        void release(size_t index);
+        // 以第index个实例处理输入，无论是否抛出异常都归还实例
+        std::shared_ptr<DataObject> run(size_t index, const Inputs &inputs);
+
+        std::vector<std::shared_ptr<ProcessingTask>> instances_;
+        TaskConcurrency concurrency_;
+        std::mutex mutex_;
+        std::vector<size_t> freeInstances_;
+        std::deque<Grant> waiting_;
+    };
+
     // 定义任务注册表类，用于管理所有处理任务
     class TaskRegistry
     {
     private:
-        std::unordered_map<std::string, std::shared_ptr<ProcessingTask>> tasks;
+        std::unordered_map<std::string, std::shared_ptr<TaskInstancePool>> tasks;
+        std::unordered_map<std::string, std::shared_ptr<DynamicBatcher>> batchTasks;
 
     public:
-        // 注册任务并返回任务ID
+        // 注册任务并返回任务ID，任务实例被串行调用
         template <typename T, typename... Args>
         std::string registerTask(const std::string &taskId, Args &&...args)
         {
-            tasks[taskId] = std::make_shared<T>(std::forward<Args>(args)...);
+            std::vector<std::shared_ptr<ProcessingTask>> instances{std::make_shared<T>(std::forward<Args>(args)...)};
+            tasks[taskId] = std::make_shared<TaskInstancePool>(std::move(instances), TaskConcurrency::serial());
+            batchTasks.erase(taskId);
+            return taskId;
+        }
+
+        // 按指定并发策略注册任务；Replicated模式下用相同参数构造replicas个实例
+        template <typename T, typename... Args>
+        std::string registerTask(const std::string &taskId, TaskConcurrency concurrency, Args &&...args)
+        {
+            std::vector<std::shared_ptr<ProcessingTask>> instances;
+            if (concurrency.mode == TaskConcurrency::Mode::Replicated)
+            {
+                for (size_t i = 0; i < concurrency.replicas; ++i)
+                {
+                    instances.push_back(std::make_shared<T>(args...));
+                }
+            }
+            else
+            {
+                concurrency.replicas = 1;
+                instances.push_back(std::make_shared<T>(std::forward<Args>(args)...));
+            }
+            tasks[taskId] = std::make_shared<TaskInstancePool>(std::move(instances), concurrency);
+            batchTasks.erase(taskId);
+            return taskId;
+        }
+
+        // 注册批处理任务：最多合并maxBatchSize帧，批次发起后最多等待maxWait。
+        // 批处理函数串行执行，任务实例无需支持并发调用；管道启动时登记最多同时调用的帧数
+        template <typename T, typename... Args>
+        std::string registerBatchTask(const std::string &taskId, size_t maxBatchSize,
+                                      std::chrono::microseconds maxWait, Args &&...args)
+        {
+            static_assert(std::is_base_of<BatchProcessingTask, T>::value, "T must derive from BatchProcessingTask");
+            auto task = std::make_shared<T>(std::forward<Args>(args)...);
+            batchTasks[taskId] = std::make_shared<DynamicBatcher>(
+                [task](const std::vector<DynamicBatcher::Inputs> &batch)
+                { return task->processBatch(batch); },
+                maxBatchSize, maxWait);
+            tasks.erase(taskId);
             return taskId;
         }
 
-        // 获取任务处理函数
+        // 获取批处理任务的统计信息（命中率与平均批大小），用于调整maxBatchSize与maxWait
+        DynamicBatcher::Stats getBatchStats(const std::string &taskId) const
+        {
+            auto it = batchTasks.find(taskId);
+            if (it == batchTasks.end())
+            {
+                throw std::runtime_error("Batch task not found: " + taskId);
+            }
+            return it->second->getStats();
+        }
+
+        // 获取任务的并发策略
+        TaskConcurrency getConcurrency(const std::string &taskId) const
+        {
+            if (batchTasks.count(taskId))
+            {
+                return TaskConcurrency::serial();
+            }
+            auto it = tasks.find(taskId);
+            if (it == tasks.end())
+            {
+                throw std::runtime_error("Task not found: " + taskId);
+            }
+            return it->second->getConcurrency();
+        }
+
+        // 获取任务处理函数，每次调用按并发策略租用任务实例
         std::function<std::shared_ptr<DataObject>(const std::vector<std::shared_ptr<DataObject>> &)>
         getProcessFunction(const std::string &taskId)
         {
-            if (tasks.find(taskId) == tasks.end())
+            auto batchIt = batchTasks.find(taskId);
+            if (batchIt != batchTasks.end())
             {
-                throw std::runtime_error("Task not found: " + taskId);
+                // 调度器提交的调用挂起在批次中，凑满或超时后批次作为一个任务提交到线程池
+                return SuspendableTask::Function{batchIt->second};
             }
 
-            return [task = tasks[taskId]](const std::vector<std::shared_ptr<DataObject>> &inputs)
+            auto it = tasks.find(taskId);
+            if (it == tasks.end())
             {
-                return task->process(inputs);
-            };
+                throw std::runtime_error("Task not found: " + taskId);
+            }
+
+            // 调度器识别出实例池后通过invoke提交，没有空闲实例时挂起节点而不是阻塞工作线程
+            return SuspendableTask::Function{it->second};
         }
     };
 } // namespace GryFlux
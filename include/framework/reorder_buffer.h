@@ -0,0 +1,123 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "framework/data_object.h"
+
+namespace GryFlux
+{
+
+    // 占位输出：按序输出时代替失败或超时的帧，序号与被代替的帧相同
+    class FramePlaceholder : public DataObject
+    {
+    public:
+        enum class Reason
+        {
+            Failed,  // 处理失败或结果为空
+            Late,    // 超过等待时间或超出重排窗口，被跳过
+            Dropped, // 无法在截止时间前完成，被管道丢弃
+            Pruned   // 输出节点因输入边条件被剪枝（输出为Skip/Empty）
+        };
+
+        explicit FramePlaceholder(Reason reason) : reason_(reason) {}
+        Reason getReason() const { return reason_; }
+
+    private:
+        Reason reason_;
+    };
+
+    // 迟到或失败帧的处理策略
+    enum class LateFramePolicy
+    {
+        Skip,       // 直接跳过，不产生输出
+        Placeholder // 输出FramePlaceholder
+    };
+
+    // 重排缓冲区：按完成顺序提交的结果严格按帧序号释放。
+    // 缓冲区大小固定为窗口大小；队首帧迟迟未完成时，超过等待时间或超出窗口后按策略跳过，
+    // 避免一个慢帧让整个流停住。跳过之后才到达的结果会被丢弃
+    class ReorderBuffer
+    {
+    public:
+        using ReleaseCallback = std::function<void(std::shared_ptr<DataObject>)>;
+
+        struct Stats
+        {
+            size_t released = 0;     // 按序释放的正常结果
+            size_t failed = 0;       // 结果为空的帧
+            size_t dropped = 0;      // 因截止时间被丢弃的帧
+            size_t pruned = 0;       // 输出节点被剪枝的帧
+            size_t skipped = 0;      // 超时或超出窗口而被跳过的帧
+            size_t lateArrivals = 0; // 被跳过后才到达、已丢弃的结果
+            size_t placeholders = 0; // 输出的占位数量
+            size_t maxBuffered = 0;  // 运行期间等待队首帧的最大结果数
+        };
+
+        // timeout为0时不按时间跳过，只在超出窗口时跳过
+        ReorderBuffer(size_t window, std::chrono::milliseconds timeout, LateFramePolicy policy,
+                      ReleaseCallback release);
+
+        // 提交帧的结果，result为空时reason说明原因；可从多个线程并发调用
+        void submit(uint64_t sequence, std::shared_ptr<DataObject> result,
+                    FramePlaceholder::Reason reason = FramePlaceholder::Reason::Failed);
+
+        // 检查队首帧是否已超时，由处理线程空闲时调用；没有等待中的帧时不加锁。
+        // submit也会做同样的检查，因此负载持续时超时同样生效
+        void poll();
+
+        // 输入结束后调用：释放endSequence之前的所有结果，尚未完成的帧按策略跳过
+        void flush(uint64_t endSequence);
+
+        Stats getStats() const;
+
+    private:
+        struct Slot
+        {
+            bool ready = false;
+            std::shared_ptr<DataObject> result;
+            FramePlaceholder::Reason reason = FramePlaceholder::Reason::Failed;
+        };
+
+        // 以下方法在持有mutex_时调用
+        void releaseReady();
+        void skipHead();
+        void skipExpiredHead(); // 队首帧等待超过timeout_时跳过
+        void emit(uint64_t sequence, std::shared_ptr<DataObject> result, FramePlaceholder::Reason reason);
+        void updateWaiting();
+
+        std::vector<Slot> slots_; // 按 序号 % 窗口 索引
+        std::chrono::milliseconds timeout_;
+        LateFramePolicy policy_;
+        ReleaseCallback release_;
+
+        mutable std::mutex mutex_;
+        uint64_t nextSequence_ = 0;
+        size_t buffered_ = 0;
+        std::atomic<bool> waiting_; // 队首帧缺失且有后续结果在等待
+        uint64_t headSequence_ = 0; // 开始计时时的队首帧
+        std::chrono::time_point<std::chrono::high_resolution_clock> headWaitStart_;
+        Stats stats_;
+    };
+
+} // namespace GryFlux
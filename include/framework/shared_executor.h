@@ -0,0 +1,67 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include "framework/executor.h"
+
+namespace GryFlux
+{
+
+    // 进程内多条管道共用的执行器：所有管道的节点都在同一组工作线程上执行，线程数不随管道数量增长。
+    // 每条管道通过attach()取得一个带权重的份额，份额在线程池中同时排队或执行的任务数不超过
+    // 线程数 × 份额权重 / 活跃份额权重之和（向上取整，至少为1），超出的任务在份额内按优先级等待。
+    // 只有有任务的份额计入权重之和，空闲管道不占配额，其余管道可以用满全部线程
+    class SharedExecutor : public std::enable_shared_from_this<SharedExecutor>
+    {
+    public:
+        // numThreads 为 0 时按 affinity 绑定的 CPU 数量（不绑定时为硬件线程数）。
+        // 底层固定使用单一共享队列的 ThreadPool：令牌需要在所有份额之间按 FIFO 轮转，
+        // 工作窃取线程池中工作线程重新提交的令牌进入本地双端队列并按 LIFO 取出，会被同一份额独占
+        static std::shared_ptr<SharedExecutor> create(size_t numThreads = 0,
+                                                      const CpuAffinity &affinity = CpuAffinity::any(),
+                                                      const ThreadPolicy &policy = ThreadPolicy());
+
+        // 进程级默认实例，首次调用时按硬件线程数创建
+        static std::shared_ptr<SharedExecutor> getInstance();
+
+        // 创建一个份额，weight 为 0 时按 1 处理；maxTasks 大于 0 时另外限制份额的并发任务数
+        std::shared_ptr<Executor> attach(size_t weight = 1, size_t maxTasks = 0);
+
+        // 获取工作线程数量
+        size_t getThreadCount() const { return pool_->getThreadCount(); }
+
+        // 获取线程池中待处理的任务数量（不含各份额内等待的任务）
+        size_t getTaskCount() const { return pool_->getTaskCount(); }
+
+        bool isThreadPolicyGranted() const { return pool_->isThreadPolicyGranted(); }
+
+    private:
+        class Share;
+
+        explicit SharedExecutor(std::shared_ptr<Executor> pool);
+
+        // 按当前活跃份额的权重之和计算份额的配额
+        size_t quotaFor(size_t weight) const;
+
+        std::shared_ptr<Executor> pool_;
+        std::atomic<size_t> activeWeight_;
+    };
+
+} // namespace GryFlux
@@ -0,0 +1,140 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "framework/data_object.h"
+#include "framework/graph_template.h"
+#include "framework/task_node.h"
+#include "utils/cpu_topology.h"
+#include "utils/thread_priority.h"
+
+namespace GryFlux
+{
+
+    // 阶段并行执行：计算图模板中的每个处理节点成为一个长期存在的阶段，
+    // 拥有独立的有界输入队列和固定数量的工作线程，帧像流水线一样依次流过各阶段。
+    // 节点的所有输入都完成后，帧才进入该节点的阶段队列；队列满时上游阶段阻塞等待（背压）。
+    // 阶段队列按输入帧的截止时间优先出队，预计无法按时完成的帧在进入阶段前被丢弃
+    class StageGraph
+    {
+    public:
+        // 单个阶段的配置
+        struct StageConfig
+        {
+            size_t workers = 1;       // 工作线程数
+            size_t queueCapacity = 4; // 输入队列容量（帧数）
+            CpuAffinity affinity;     // 工作线程绑定的CPU，默认不限制
+            ThreadPolicy policy;      // 工作线程的调度策略，默认不修改
+        };
+
+        // 单个阶段的统计信息
+        struct StageStats
+        {
+            std::string name;
+            size_t workers = 0;
+            size_t queueCapacity = 0;
+            size_t queueDepth = 0;      // 当前队列中的帧数
+            size_t maxQueueDepth = 0;   // 运行期间队列的最大深度
+            size_t processed = 0;       // 已处理的帧数
+            double totalTimeMs = 0.0;   // 处理函数累计耗时
+            double blockedTimeMs = 0.0; // 上游因本阶段队列满而阻塞的累计时间
+            size_t dropped = 0;         // 在本阶段因截止时间被丢弃的帧数
+            size_t pruned = 0;          // 因输入边条件不满足而未进入本阶段的帧数
+            ThreadPolicy policy;        // 请求的调度策略
+            bool policyGranted = true;  // 所有工作线程是否都获得了请求的调度策略
+        };
+
+        // 帧的处理结果
+        enum class FrameStatus
+        {
+            Completed, // 所有阶段正常执行
+            Failed,    // 某个阶段抛出了异常
+            Dropped    // 无法在截止时间前完成，剩余阶段未执行
+        };
+
+        // 帧到达输出节点时调用：sequence为输入帧的序号，result为输出节点的结果。
+        // 输出阶段有多个工作线程时会被并发调用
+        using OutputCallback = std::function<void(uint64_t sequence, std::shared_ptr<DataObject> result, FrameStatus status)>;
+
+        // 模板必须已编译；configs按节点ID覆盖默认阶段配置
+        StageGraph(const GraphTemplate &graph,
+                   const std::unordered_map<std::string, StageConfig> &configs,
+                   OutputCallback onOutput);
+        ~StageGraph();
+
+        StageGraph(const StageGraph &) = delete;
+        StageGraph &operator=(const StageGraph &) = delete;
+
+        // 启动所有阶段的工作线程
+        void start();
+
+        // 提交一帧输入，后继阶段队列满时阻塞
+        void push(std::shared_ptr<DataObject> input);
+
+        // 按拓扑序依次关闭各阶段并等待已提交的帧全部处理完成
+        void stop();
+
+        // 获取各阶段的统计信息，按拓扑序排列，不包含输入节点
+        std::vector<StageStats> getStageStats() const;
+
+        // 已到达输出节点的帧数及其从提交到输出的累计耗时
+        size_t getCompletedFrames() const { return completedFrames_.load(); }
+        double getTotalLatencyMs() const { return totalLatencyNs_.load() / 1e6; }
+
+    private:
+        struct Frame;
+        struct Stage;
+
+        void workerLoop(size_t index);
+        // 记录节点结果，并把所有输入都已完成的后继节点的帧放入对应阶段队列；
+        // 输入边条件不满足的后继不进入队列，就地剪枝并继续传播
+        void complete(const std::shared_ptr<Frame> &frame, size_t index, std::shared_ptr<DataObject> result);
+        // 节点不再读取输入：最后一个读取者释放该输入的结果
+        void releaseInputs(Frame &frame, size_t index);
+        // 从该节点到输出的剩余关键路径，按各阶段的平均耗时估计；只读取预先计算的表，不做遍历
+        DataObject::Clock::duration remainingPath(size_t index) const;
+        // 按各阶段当前的平均耗时重新计算剩余关键路径表，距上次刷新不足kPathRefreshInterval时跳过
+        void refreshRemainingPaths();
+        static constexpr std::chrono::milliseconds kPathRefreshInterval{10};
+
+        std::vector<GraphTemplate::NodeSpec> nodes_;   // 按拓扑序
+        std::vector<std::vector<size_t>> successors_;  // 按节点序号索引
+        std::vector<std::unique_ptr<Stage>> stages_;   // 输入节点没有阶段
+        size_t inputIndex_ = 0;
+        size_t outputIndex_ = 0;
+        std::unique_ptr<std::atomic<DataObject::Clock::rep>[]> remainingPath_; // 按节点序号索引
+        std::atomic<DataObject::Clock::rep> nextPathRefresh_{0};              // 下次允许刷新的时刻
+        OutputCallback onOutput_;
+        bool running_ = false;
+
+        std::atomic<size_t> completedFrames_;
+        std::atomic<uint64_t> totalLatencyNs_;
+    };
+
+} // namespace GryFlux
@@ -20,17 +20,48 @@
 #include <string>
 #include <thread>
 #include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
 #include <functional>
 #include <unordered_map>
 #include <chrono>
 #include "framework/pipeline_builder.h"
+#include "framework/reorder_buffer.h"
+#include "framework/shared_executor.h"
+#include "framework/stage_graph.h"
 #include "framework/thread_pool.h"
 #include "framework/task_scheduler.h"
+#include "utils/lockfree_queue.h"
 #include "utils/threadsafe_queue.h"
 
 namespace GryFlux
 {
 
+    // 管道执行模式
+    enum class ExecutionMode
+    {
+        TaskGraph,    // 每帧实例化/复用一份计算图，节点提交到共享线程池（默认）
+        StageParallel // 每个处理节点是常驻阶段，帧像流水线一样流过各阶段，需要计算图模板
+    };
+
+    // 输入队列满时的处理策略
+    enum class InputOverflowPolicy
+    {
+        Block,      // 阻塞生产者直到队列有空位（默认）
+        DropNewest, // 丢弃新到达的输入
+        DropOldest, // 丢弃队列中最早的输入，为新输入腾出位置
+        KeepLatest  // 单槽信箱：队列只保留最新的一个输入，新输入替换尚未处理的旧输入
+    };
+
+    // 输入、输出队列的实现
+    enum class QueueType
+    {
+        Locked,       // 互斥锁保护的队列（默认），输出队列不限容量
+        LockFreeMPMC, // 无锁有界环形缓冲区，多生产者多消费者
+        LockFreeSPSC  // 无锁有界环形缓冲区，单生产者单消费者
+    };
+
     // 流式处理管道，用于处理持续输入的数据
     class StreamingPipeline
     {
@@ -40,7 +71,14 @@ namespace GryFlux
                                                      const std::string &)>;
 
         StreamingPipeline(size_t numThreads = 0,
-                          size_t queueSize = 100);
+                          size_t queueSize = 100,
+                          size_t maxFramesInFlight = 1,
+                          ThreadPoolType poolType = ThreadPoolType::SharedQueue,
+                          const CpuAffinity &affinity = CpuAffinity::any());
+        // 使用外部执行器（如SharedExecutor::attach()返回的份额），多条管道共享同一组工作线程
+        StreamingPipeline(std::shared_ptr<Executor> executor,
+                          size_t queueSize = 100,
+                          size_t maxFramesInFlight = 1);
         ~StreamingPipeline();
 
         // 启动流式处理
@@ -49,21 +87,101 @@ namespace GryFlux
         // 停止流式处理
         void stop();
 
-        // 设置处理函数
+        // 设置处理函数，每帧调用一次以构建计算图
         void setProcessor(ProcessorFunction processor);
 
-        // 添加输入数据
+        // 设置已编译的计算图模板，替代处理函数：每个在途帧槽位只实例化一次，
+        // 之后每帧只绑定输入，输出节点ID取自模板
+        void setGraphTemplate(std::shared_ptr<GraphTemplate> graph);
+
+        // 输入队列的计数
+        struct InputQueueStats
+        {
+            size_t accepted = 0;      // 进入输入队列的输入
+            size_t blocked = 0;       // Block策略下生产者等待过的次数
+            size_t droppedNewest = 0; // DropNewest策略下被丢弃的新输入
+            size_t droppedOldest = 0; // DropOldest策略下被挤出队列的旧输入
+            size_t replaced = 0;      // KeepLatest策略下被新输入替换的旧输入
+        };
+
+        // 添加输入数据。队列满时按溢出策略处理；因策略被丢弃的输入同样返回true，
+        // 只有管道未运行或数据为空时返回false
         bool addInput(std::shared_ptr<DataObject> data);
 
+        // 设置输入队列满时的处理策略，需在启动前设置
+        void setInputOverflowPolicy(InputOverflowPolicy policy);
+        InputOverflowPolicy getInputOverflowPolicy() const { return overflowPolicy_; }
+
+        // 获取输入队列的计数
+        InputQueueStats getInputQueueStats() const;
+
+        // 设置输入队列的实现，容量为构造时的queueSize，需在启动前设置。
+        // LockFreeSPSC要求只有一个生产者线程、只有一个处理线程取输入（最大在途帧数为1或StageParallel模式），
+        // 且溢出策略为Block或DropNewest（其余策略会从生产者一侧挤出旧输入）
+        void setInputQueueType(QueueType type);
+
+        // 设置输出队列的实现，需在启动前设置。无锁实现的容量固定为capacity（为0时取queueSize），
+        // 队列满时处理线程等待消费者取走结果。LockFreeSPSC要求只有一个消费者线程，
+        // 且结果由同一时刻唯一的线程放入（开启按序输出，或TaskGraph模式下最大在途帧数为1）
+        void setOutputQueueType(QueueType type, size_t capacity = 0);
+
         // 尝试获取输出，非阻塞
         bool tryGetOutput(std::shared_ptr<DataObject> &output);
 
-        // 获取输出，阻塞直到有输出或流关闭
+        // 获取输出，阻塞直到有输出或流关闭；流关闭且输出取空时output为空
         void getOutput(std::shared_ptr<DataObject> &output);
 
+        // 最多等待timeout获取输出，超时或流关闭且输出取空时返回false
+        bool waitForOutput(std::shared_ptr<DataObject> &output, std::chrono::milliseconds timeout);
+
+        // 批量获取已就绪的输出，最多maxCount个，返回实际数量；非阻塞
+        size_t tryGetOutputBulk(std::shared_ptr<DataObject> *outputs, size_t maxCount);
+
+        // 最多等待timeout直到有输出，再批量取出最多maxCount个；超时或流关闭且输出取空时返回0
+        size_t waitForOutputBulk(std::shared_ptr<DataObject> *outputs, size_t maxCount,
+                                 std::chrono::milliseconds timeout);
+
         // 设置输出节点ID
         void setOutputNodeId(const std::string &outputId);
 
+        // 设置最大在途帧数，每个在途帧拥有独立的计算图实例，共享同一线程池
+        void setMaxFramesInFlight(size_t maxFrames);
+
+        // 获取最大在途帧数
+        size_t getMaxFramesInFlight() const { return maxFramesInFlight_; }
+
+        // 设置执行模式；StageParallel模式下在途帧数由各阶段队列容量决定
+        void setExecutionMode(ExecutionMode mode);
+        ExecutionMode getExecutionMode() const { return executionMode_; }
+
+        // 设置StageParallel模式下某个节点的阶段配置（工作线程数、输入队列容量与工作线程绑定的CPU）
+        void setStageConfig(const std::string &nodeId, size_t workers, size_t queueCapacity,
+                            const CpuAffinity &affinity = CpuAffinity::any());
+        // 设置完整的阶段配置，包括工作线程的调度策略（实时优先级、nice值、mlockall）
+        void setStageConfig(const std::string &nodeId, const StageGraph::StageConfig &config);
+
+        // 设置共享线程池工作线程的调度策略，需在启动前调用（会按原有配置重建线程池）。
+        // 是否生效可通过isThreadPolicyGranted()查询，停止时也会输出到统计信息。
+        // 使用外部执行器时抛出异常，调度策略应在创建执行器时指定
+        void setThreadPolicy(const ThreadPolicy &policy);
+        bool isThreadPolicyGranted() const { return threadPool_->isThreadPolicyGranted(); }
+
+        // 设置TaskKind::Io节点使用的执行器（如createIoThreadPool()），需在启动前调用；
+        // 未设置时I/O节点与计算节点共用线程池。StageParallel模式下各阶段使用自己的线程，不受影响
+        void setIoExecutor(std::shared_ptr<Executor> ioExecutor);
+        std::shared_ptr<Executor> getIoExecutor() const { return ioExecutor_; }
+
+        // 设置是否按帧序号输出（默认开启）。window为重排窗口大小，
+        // 队首帧未完成而等待中的结果超过窗口时，队首帧按迟到处理
+        void setOrderedOutput(bool enable, size_t window = 64);
+        bool isOrderedOutput() const { return orderedOutput_; }
+
+        // 设置迟到或失败帧的处理策略；timeout为队首帧的最长等待时间，为0时只按窗口跳过
+        void setLateFramePolicy(LateFramePolicy policy, std::chrono::milliseconds timeout);
+
+        // 获取StageParallel模式下各阶段的统计信息，可在运行中调用以观察瓶颈
+        std::vector<StageGraph::StageStats> getStageStats() const;
+
         // 检查输入队列是否为空
         bool inputEmpty() const;
 
@@ -82,6 +200,16 @@ namespace GryFlux
         // 获取处理错误数量
         size_t getErrorCount() const;
 
+        // 获取因截止时间而丢弃的帧数，不计入错误数量
+        size_t getDroppedFrameCount() const { return droppedFrames_.load(); }
+
+        // 获取输出节点因输入边条件被剪枝的帧数（输出为Skip/Empty的TaskOutcome），不计入错误数量
+        size_t getPrunedFrameCount() const { return prunedFrames_.load(); }
+
+        // 设置默认的单帧时间预算：未自带截止时间的输入在addInput时获得截止时间 = 当前时间 + budget，
+        // 为0时不设置。在途帧按截止时间优先调度，无法按时完成的帧在后续节点执行前被丢弃
+        void setFrameDeadline(std::chrono::milliseconds budget);
+
         // 检查管道是否正在运行
         bool isRunning() const;
 
@@ -91,6 +219,9 @@ namespace GryFlux
         // 检查输出是否活跃
         bool isOutputActive() const { return output_active_.load(); }
 
+        // 检查输出是否已关闭：本次运行的所有结果都已放入输出队列
+        bool isOutputClosed() const { return outputQueue_->closed(); }
+
         // 设置是否启用性能分析
         void enableProfiling(bool enable) { profilingEnabled_ = enable; }
 
@@ -98,32 +229,112 @@ namespace GryFlux
         bool isProfilingEnabled() const { return profilingEnabled_; }
 
     private:
-        void processingLoop();
+        // 单个任务的累计执行时间
+        struct TaskStat
+        {
+            std::string name;
+            double totalTimeMs = 0.0;
+            size_t count = 0;
+        };
+
+        // 每个在途帧槽位独立统计，按任务序号索引，停止时再按名称合并
+        struct SlotStats
+        {
+            std::vector<TaskStat> tasks;
+            double totalProcessingTime = 0.0; // 单位：毫秒
+        };
+
+        void processingLoop(size_t slot);
+        // 阻塞等待下一个输入，输入队列关闭且取空时返回false；
+        // 按序输出时等待期间定期检查重排缓冲区的队首帧是否超时
+        bool popInput(std::shared_ptr<DataObject> &input);
+        // 取走一个输入后唤醒等待队列空位的生产者
+        void notifyInputPopped();
+        // 交付一帧的处理结果，result为空时reason说明原因；按序输出时经过重排缓冲区。
+        // 输出节点的结果为TaskOutcome时不交给消费者，按其种类记为失败或剪枝
+        void deliverResult(uint64_t sequence, std::shared_ptr<DataObject> result,
+                           FramePlaceholder::Reason reason = FramePlaceholder::Reason::Failed);
+        // 处理线程全部退出时调用，释放重排缓冲区中剩余的结果并关闭输出
+        void finishOutput();
+        void stageFeedLoop();
+        void logStageStats(double totalTimeMs) const;
+        static void collectTaskStats(SlotStats &stats, const TaskScheduler &scheduler);
+
+        // 向批处理等可挂起任务登记的同时调用帧数，停止时按登记的数量注销
+        using CallerRegistrations = std::vector<std::pair<std::shared_ptr<SuspendableTask>, size_t>>;
+        static void registerCallers(CallerRegistrations &registrations, std::shared_ptr<SuspendableTask> task,
+                                    size_t count);
+        static void unregisterCallers(CallerRegistrations &registrations);
 
-        std::shared_ptr<PipelineBuilder> pipelineBuilder_; // 新增：用于重用PipelineBuilder对象
+        // 所有在途帧共享的线程池
+        std::shared_ptr<Executor> threadPool_;
+        ThreadPoolType poolType_;
+        CpuAffinity poolAffinity_;
+        ThreadPolicy poolPolicy_;
+        bool externalExecutor_; // 执行器由外部传入，不能重建
+        std::shared_ptr<Executor> ioExecutor_; // I/O节点的执行器，为空时使用threadPool_
+        // 所有在途帧槽位共享的节点执行时间估计，跨帧与跨重启保留，更换计算图时重建
+        std::shared_ptr<TaskTimeEstimates> timeEstimates_ = std::make_shared<TaskTimeEstimates>();
+
+        using DataObjectQueue = std::shared_ptr<blocking_queue<std::shared_ptr<DataObject>>>;
+        static DataObjectQueue createQueue(QueueType type, size_t capacity);
 
-        using DataObjectQueue = std::shared_ptr<threadsafe_queue<std::shared_ptr<DataObject>>>;
         DataObjectQueue inputQueue_;
+        QueueType inputQueueType_ = QueueType::Locked;
+        InputOverflowPolicy overflowPolicy_ = InputOverflowPolicy::Block;
+        std::mutex inputMutex_; // 多个生产者之间串行化容量检查、挤出、入队与序号分配，阻塞等待与交付时不持有
+        std::condition_variable inputNotFull_;       // Block策略下等待队列空位的生产者，处理线程取走输入时唤醒
+        std::atomic<size_t> waitingProducers_{0};    // 正在等待inputNotFull_的生产者数量
+        size_t pendingEvictions_ = 0;                // 已挤出、尚未交付占位结果的addInput调用，受inputMutex_保护
+        std::condition_variable evictionsDelivered_; // pendingEvictions_归零时通知finishOutput
+        std::atomic<size_t> inputAccepted_{0};
+        std::atomic<size_t> inputBlocked_{0};
+        std::atomic<size_t> inputDroppedNewest_{0};
+        std::atomic<size_t> inputDroppedOldest_{0};
+        std::atomic<size_t> inputReplaced_{0};
         std::atomic<bool> input_active_;
         DataObjectQueue outputQueue_;
+        QueueType outputQueueType_ = QueueType::Locked;
         std::atomic<bool> output_active_;
 
         ProcessorFunction processor_;
+        std::shared_ptr<GraphTemplate> graphTemplate_;
         std::string outputNodeId_;
-        std::thread processingThread_;
+        std::vector<std::thread> processingThreads_; // 每个在途帧槽位一个处理线程
+        std::atomic<size_t> activeProcessingLoops_;
         std::atomic<bool> running_;
         size_t queueMaxSize_;
+        size_t maxFramesInFlight_;
+
+        // 按序输出
+        std::atomic<uint64_t> nextSequence_;
+        bool orderedOutput_ = true;
+        size_t reorderWindow_ = 64;
+        LateFramePolicy lateFramePolicy_ = LateFramePolicy::Skip;
+        std::chrono::milliseconds lateFrameTimeout_{1000};
+        std::unique_ptr<ReorderBuffer> reorderBuffer_;
+
+        // StageParallel模式
+        ExecutionMode executionMode_ = ExecutionMode::TaskGraph;
+        std::unordered_map<std::string, StageGraph::StageConfig> stageConfigs_;
+        std::unique_ptr<StageGraph> stageGraph_;
+
+        // 计算图模板中的可挂起任务的登记，处理函数模式下由各槽位自行登记
+        CallerRegistrations callerRegistrations_;
 
         // 统计信息
         std::atomic<size_t> processedItems_;
         std::atomic<size_t> errorCount_;
+        std::atomic<size_t> droppedFrames_;
+        std::atomic<size_t> prunedFrames_;
+        std::chrono::milliseconds frameBudget_{0};
         double totalProcessingTime_; // 单位：毫秒
 
         // 是否启用性能分析
         bool profilingEnabled_ = false;
 
-        // 用于存储同名任务的统计数据: <任务名称, <总执行时间, 执行次数>>
-        std::unordered_map<std::string, std::pair<double, size_t>> taskStats_;
+        // 各槽位的任务统计数据
+        std::vector<SlotStats> slotStats_;
 
         std::chrono::time_point<std::chrono::high_resolution_clock> startTime_;
     };
@@ -0,0 +1,74 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "framework/data_object.h"
+#include "framework/executor.h"
+
+namespace GryFlux
+{
+
+    // 可挂起的任务：调用所需的资源（空闲的任务实例、凑齐的批次）暂不可用时，调用被挂起而不是阻塞调用线程。
+    // TaskRegistry的实例池与批处理任务实现此接口，调度器通过invoke提交节点，
+    // 工作线程不会停在等待实例或批次上，而是继续执行其他就绪节点
+    class SuspendableTask
+    {
+    public:
+        using Inputs = std::vector<std::shared_ptr<DataObject>>;
+        // 挂起的调用完成时调用；error非空表示处理函数抛出了异常
+        using Completion = std::function<void(std::shared_ptr<DataObject> result, std::exception_ptr error)>;
+
+        virtual ~SuspendableTask() = default;
+
+        // 阻塞调用，直到结果可用；供直接调用处理函数的场景（阶段并行模式、用户代码）使用
+        virtual std::shared_ptr<DataObject> process(const Inputs &inputs) = 0;
+
+        // 非阻塞调用：资源可用时在当前线程执行，写入result并返回true，处理函数的异常直接抛出；
+        // 否则挂起调用并返回false，之后在executor上以priority继续执行，完成时在执行它的线程上调用done
+        virtual bool invoke(const Inputs &inputs, std::shared_ptr<DataObject> &result,
+                            Executor &executor, uint64_t priority, Completion done) = 0;
+
+        // 登记或注销最多同时调用本任务的帧数（如管道的在途帧数），批处理任务据此判断批次何时凑满；默认忽略
+        virtual void addCallers(size_t) {}
+        virtual void removeCallers(size_t) {}
+
+        // TaskRegistry::getProcessFunction返回的std::function的目标类型，调度器据此识别可挂起的任务
+        struct Function
+        {
+            std::shared_ptr<SuspendableTask> task;
+
+            std::shared_ptr<DataObject> operator()(const Inputs &inputs) const
+            {
+                return task->process(inputs);
+            }
+        };
+
+        // 取出处理函数背后的可挂起任务，不是由TaskRegistry创建的处理函数返回空
+        static std::shared_ptr<SuspendableTask> from(const std::function<std::shared_ptr<DataObject>(const Inputs &)> &func)
+        {
+            const auto *target = func.target<Function>();
+            return target ? target->task : nullptr;
+        }
+    };
+
+} // namespace GryFlux
@@ -22,32 +22,137 @@
 #include <functional>
 #include <atomic>
 #include <chrono>
-#include <mutex>
+#include <cstdint>
 #include "framework/data_object.h"
+#include "framework/executor.h"
+#include "framework/suspendable_task.h"
 
 namespace GryFlux
 {
 
+    // 输入边条件：前驱结果的类别在条件内时本节点才执行，否则本节点被剪枝、不会被调度执行，
+    // 其结果为传播下来的TaskOutcome。可按位组合，如OnValue | OnEmpty表示有无结果都执行
+    enum class EdgeCondition : uint8_t
+    {
+        OnValue = 1, // 前驱产生正常结果（默认）
+        OnSkip = 2,  // 前驱输出TaskOutcome::skip()
+        OnEmpty = 4, // 前驱输出TaskOutcome::empty()
+        OnError = 8, // 前驱输出TaskOutcome::error()、结果为空或执行失败
+        Always = 15  // 无条件执行，由处理函数自行检查TaskOutcome
+    };
+
+    inline EdgeCondition operator|(EdgeCondition a, EdgeCondition b)
+    {
+        return static_cast<EdgeCondition>(static_cast<uint8_t>(a) | static_cast<uint8_t>(b));
+    }
+
+    // 条件condition是否接受category类别的结果
+    inline bool hasCondition(EdgeCondition condition, EdgeCondition category)
+    {
+        return (static_cast<uint8_t>(condition) & static_cast<uint8_t>(category)) != 0;
+    }
+
+    // 任务类型：决定节点提交到哪个执行器。I/O任务（文件读写、模型加载、等待设备等）大部分时间阻塞在
+    // 系统调用上，放到单独的、线程数超额配置的I/O执行器中，不占用按核心数配置的计算线程
+    enum class TaskKind : uint8_t
+    {
+        Compute, // 计算密集（默认）
+        Io       // I/O密集
+    };
+
+    // 结果所属的条件类别：正常结果为OnValue，TaskOutcome按其种类，空结果视为OnError
+    EdgeCondition classifyResult(const std::shared_ptr<DataObject> &result);
+
+    // 逐条检查输入边条件，得出节点被剪枝时应传播的结果：
+    // 普通数据边遇到条件输出时原样传播（Error优先于Empty优先于Skip），分支边未被选中时传播Skip
+    class EdgeConditionCheck
+    {
+    public:
+        void add(const std::shared_ptr<DataObject> &input, EdgeCondition condition);
+
+        // 所有输入边都满足条件时返回空
+        const std::shared_ptr<DataObject> &getPrunedResult() const { return pruned_; }
+
+    private:
+        std::shared_ptr<DataObject> pruned_;
+        uint8_t severity_ = 0;
+    };
+
     // 任务节点基类
     class TaskNode
     {
     public:
-        using TaskId = std::string;
-
-        TaskNode(TaskId id);
+        // 节点序号，由调度器在构建计算图时按添加顺序分配，稠密且从0开始
+        using TaskId = size_t;
+        static constexpr TaskId kInvalidTaskId = static_cast<TaskId>(-1);
+
+        // 节点执行状态，保存在单个原子变量中：
+        // Pending -> Running -> Done/Failed/Skipped，或 Pending -> Cancelled；reset()回到Pending
+        enum class State : uint8_t
+        {
+            Pending,  // 等待执行
+            Running,  // 正在执行
+            Done,     // 执行完成，结果已发布
+            Failed,   // 执行过程中抛出异常
+            Cancelled, // 未执行即被取消（如帧已无法在截止时间前完成）
+            Skipped    // 输入边条件不满足而被剪枝，结果为传播下来的TaskOutcome
+        };
+
+        TaskNode(std::string name);
         virtual ~TaskNode() = default;
 
         TaskId getId() const;
+        void setId(TaskId id);
+        const std::string &getName() const; // 名称仅作为元数据，用于日志与统计输出
         void addDependency(std::shared_ptr<TaskNode> node);
         const std::vector<std::shared_ptr<TaskNode>> &getDependencies() const;
         void setResult(std::shared_ptr<DataObject> result);
-        std::shared_ptr<DataObject> getResult();
-        bool isExecuted() const;
+        std::shared_ptr<DataObject> getResult() const; // Done与Skipped状态下有效
+        // 释放结果但保持状态不变：调度器在所有后继读取完毕后调用，之后getResult返回空
+        void releaseResult();
+        // 移交结果：返回结果并清空，状态不变；只能由唯一剩余的读取者调用
+        std::shared_ptr<DataObject> takeResult();
+
+        // 调度器在执行前标记第position个依赖的结果可以移交给本节点（本节点是其唯一剩余的读取者）
+        void setInputTransferable(size_t position, bool transferable);
+        bool isInputTransferable(size_t position) const;
+
+        // 结果就是某个未独占的输入对象（处理函数原样返回了输入），该对象仍被其他节点持有，不能移交给后继
+        bool isResultShared() const;
+
+        // 第position个依赖的输入边条件，构建阶段设置，默认为OnValue
+        void setInputCondition(size_t position, EdgeCondition condition);
+        EdgeCondition getInputCondition(size_t position) const;
+
+        // 任务类型，构建阶段设置，默认为Compute
+        void setKind(TaskKind kind);
+        TaskKind getKind() const;
+
+        // 按输入边条件检查已完成的依赖：全部满足时返回空，否则返回剪枝后应传播的结果
+        std::shared_ptr<DataObject> checkInputConditions() const;
+
+        // 剪枝尚未开始执行的节点，不调用execute，结果为outcome；节点已开始执行时返回false
+        bool prune(std::shared_ptr<DataObject> outcome);
+
+        State getState() const;
+        bool isExecuted() const; // Done、Failed、Cancelled与Skipped都视为已执行
+
+        // 取消尚未开始执行的节点，结果为空；节点已开始执行时返回false
+        bool cancel();
 
         virtual std::shared_ptr<DataObject> execute() = 0;
         void executeOnce(); //保证同一个任务不会被多次执行
+
+        // 调度器使用的执行入口：与executeOnce相同，但处理函数可挂起（见SuspendableTask）时不在当前线程等待
+        // 任务实例或批次。在当前线程执行完成时返回true，不调用done；执行被挂起时返回false，
+        // 之后由完成执行的线程发布结果并调用done。executor与priority用于挂起的执行恢复时提交
+        virtual bool executeAsync(Executor &executor, uint64_t priority, std::function<void()> done);
         virtual bool isReady() const; // 添加isReady方法
 
+        // 清除执行状态与结果，使节点可以在下一帧复用
+        // 调用方需保证此时没有其他线程正在执行或读取该节点
+        virtual void reset();
+
         // 执行时间相关方法
         void startExecution();
         void endExecution();
@@ -56,17 +161,21 @@ namespace GryFlux
 
     protected:
         TaskId id_;
+        std::string name_;
         std::vector<std::shared_ptr<TaskNode>> dependencies_;
+        // 结果与执行时间由执行线程在发布Done之前写入，
+        // 读取方通过对state_的acquire加载获得可见性，无需加锁
         std::shared_ptr<DataObject> result_;
-        bool executed_;
+        std::atomic<State> state_;
+        std::vector<char> transferableInputs_; // 按依赖位置索引
+        bool resultShared_ = false; // 与result_一样由执行线程在发布Done之前写入
+        std::vector<EdgeCondition> inputConditions_; // 按依赖位置索引，未设置的为OnValue
+        TaskKind kind_ = TaskKind::Compute;
 
         // 任务执行时间记录
         std::chrono::time_point<std::chrono::high_resolution_clock> startTime_;
         std::chrono::time_point<std::chrono::high_resolution_clock> endTime_;
         double executionTimeMs_;
-        
-        // 互斥锁保护任务执行过程和共享数据访问，确保线程安全
-        mutable std::recursive_mutex mutex_;
 
     };
 
@@ -74,11 +183,13 @@ namespace GryFlux
     class InputNode : public TaskNode
     {
     public:
-        InputNode(TaskId id, std::shared_ptr<DataObject> data);
+        InputNode(std::string name, std::shared_ptr<DataObject> data);
         std::shared_ptr<DataObject> execute() override;
 
-    private:
-        std::shared_ptr<DataObject> data_;
+        // 绑定新一帧的输入数据（复用计算图模板实例时使用）
+        void bind(std::shared_ptr<DataObject> data);
+        void reset() override;
+
     };
 
     // 具有多个输入的任务
@@ -87,13 +198,25 @@ namespace GryFlux
     public:
         using ProcessFunction = std::function<std::shared_ptr<DataObject>(const std::vector<std::shared_ptr<DataObject>> &)>;
 
-        MultiInputTaskNode(TaskId id, ProcessFunction func,
-                           const std::vector<std::shared_ptr<TaskNode>> &inputs);
+        // conditions与inputs一一对应，为空时所有输入边都为OnValue
+        MultiInputTaskNode(std::string name, ProcessFunction func,
+                           const std::vector<std::shared_ptr<TaskNode>> &inputs,
+                           const std::vector<EdgeCondition> &conditions = {});
         std::shared_ptr<DataObject> execute() override;
+        bool executeAsync(Executor &executor, uint64_t priority, std::function<void()> done) override;
         bool isReady() const override;
 
+        // 处理函数背后的可挂起任务（TaskRegistry的实例池或批处理任务），其他处理函数为空
+        const std::shared_ptr<SuspendableTask> &getSuspendableTask() const { return suspendable_; }
+
     private:
+        // 收集所有依赖的结果作为处理函数的输入，exclusive记录移交了所有权的输入位置；有输入为空时返回false
+        bool collectInputs(std::vector<std::shared_ptr<DataObject>> &inputs, uint64_t &exclusive);
+        // 发布挂起执行的结果，error非空时与execute一样记录日志并以空结果完成
+        void completeSuspended(std::shared_ptr<DataObject> result, std::exception_ptr error, bool resultShared);
+
         ProcessFunction func_;
+        std::shared_ptr<SuspendableTask> suspendable_; // 处理函数来自TaskRegistry时可挂起执行
         std::vector<std::shared_ptr<TaskNode>> inputs_;
         std::shared_ptr<DataObject> result_;
     };
@@ -16,37 +16,143 @@
  *************************************************************************************************************************/
 #pragma once
 
+#include <atomic>
 #include <unordered_map>
 #include <string>
 #include <memory>
+#include <mutex>
 #include <future>
+#include <vector>
 #include "framework/task_node.h"
-#include "framework/thread_pool.h"
+#include "framework/executor.h"
 
 namespace GryFlux
 {
 
+    // 各节点执行时间的滑动平均，按节点名称保存。同一计算图的多个实例（多个在途帧）共享一份，
+    // 重建计算图时保留，关键路径与截止时间的估计不会因此从零开始
+    class TaskTimeEstimates
+    {
+    public:
+        // 名称对应的估计值（毫秒，0表示尚无数据），首次访问时创建；返回的引用在对象销毁前一直有效
+        std::atomic<double> &slot(const std::string &name);
+
+        // 计入一次执行时间
+        static void record(std::atomic<double> &expected, double elapsedMs);
+
+    private:
+        std::mutex mutex_;
+        std::unordered_map<std::string, std::atomic<double>> slots_;
+    };
+
     // 任务调度器
     class TaskScheduler
     {
     public:
-        explicit TaskScheduler(size_t numThreads = 0);
+        using TaskId = TaskNode::TaskId;
 
-        void addTask(std::shared_ptr<TaskNode> task);
-        std::shared_ptr<TaskNode> getTask(const std::string &id);
+        explicit TaskScheduler(size_t numThreads = 0, ThreadPoolType poolType = ThreadPoolType::SharedQueue);
+
+        // 使用外部共享的线程池，多个调度器（多个在途帧）可共用同一组工作线程
+        explicit TaskScheduler(std::shared_ptr<Executor> threadPool);
+
+        // 添加任务并分配稠密序号；同名任务会替换原节点并沿用其序号
+        TaskId addTask(std::shared_ptr<TaskNode> task);
+
+        // 按名称查找任务，仅用于构建阶段；找不到时返回kInvalidTaskId
+        TaskId findTaskId(const std::string &name) const;
+        std::shared_ptr<TaskNode> getTask(const std::string &name);
+        std::shared_ptr<TaskNode> getTask(TaskId id) const;
+
+        // 已添加的任务数量，任务序号范围为[0, getTaskCount())
+        size_t getTaskCount() const { return tasks_.size(); }
+
+        // 就绪节点按最晚开始时刻（参考时刻减去该节点到输出的剩余关键路径）提交到线程池，
+        // 路径长度由各节点执行时间的滑动平均估计，因此长分支总是先开始；
+        // 参考时刻为截止时间，没有截止时间时为execute的调用时刻
+        std::shared_ptr<DataObject> execute(TaskId outputTaskId);
         std::shared_ptr<DataObject> execute(const std::string &outputTaskId);
 
+        // 设置之后execute的截止时间：截止时间越早的帧越先执行，
+        // 预计无法在截止时间前完成的节点及其后继被取消，execute返回空结果
+        void setDeadline(DataObject::Clock::time_point deadline) { deadline_ = deadline; }
+
+        // 上一次execute是否因截止时间而取消了节点
+        bool wasCancelled() const { return cancelled_; }
+
+        // 冻结以outputTaskId为终点的执行计划，之后的execute直接复用，不再遍历计算图
+        // 需在图构建完成、首次执行之前调用；再次addTask或clear会使计划失效
+        void compile(TaskId outputTaskId);
+        void compile(const std::string &outputTaskId);
+
+        // 重置所有节点的执行状态，用于复用同一计算图处理下一帧
+        void resetTasks();
+
         // 清除所有任务
         void clear();
         
-        // 获取所有任务的执行时间统计
-        std::unordered_map<std::string, double> getTaskExecutionTimes() const;
+        // 获取所有任务的执行时间统计，按任务序号索引，未执行的任务为负值
+        std::vector<double> getTaskExecutionTimes() const;
+
+        // 设置执行时间估计，多个调度器可共享同一份；需在execute之前设置，不能为空
+        void setTimeEstimates(std::shared_ptr<TaskTimeEstimates> estimates);
+        std::shared_ptr<TaskTimeEstimates> getTimeEstimates() const { return timeEstimates_; }
+
+        // 获取调度器使用的线程池
+        std::shared_ptr<Executor> getThreadPool() const { return threadPool_; }
+
+        // 设置TaskKind::Io节点使用的执行器，未设置时I/O节点与计算节点共用线程池；需在execute之前设置
+        void setIoExecutor(std::shared_ptr<Executor> ioExecutor) { ioExecutor_ = std::move(ioExecutor); }
+        std::shared_ptr<Executor> getIoExecutor() const { return ioExecutor_; }
 
     private:
-        void executeTask(std::shared_ptr<TaskNode> task);
+        // 单次execute的调度状态：每个节点记录未完成的前驱数量，归零即提交到线程池
+        struct ExecutionContext;
+
+        // 构建以outputTask为终点、尚未执行的子图的调度状态
+        std::shared_ptr<ExecutionContext> buildExecutionContext(const std::shared_ptr<TaskNode> &outputTask);
+
+        // 将前驱计数与剩余节点数恢复为初始值
+        static void resetExecutionContext(ExecutionContext &context);
+
+        // 按当前的执行时间估计计算各节点的剩余关键路径与线程池优先级，每次execute调用一次
+        void updatePriorities(ExecutionContext &context) const;
+        // 每个节点的固定开销估计，尚无剖析数据时按节点数比较路径长度
+        static constexpr uint64_t kNodeOverheadNs = 1000;
+
+        // 帧是否已无法在截止时间前完成：当前时刻晚于该节点的最晚开始时刻，
+        // 即本节点到输出的剩余关键路径（按各节点执行时间的滑动平均估计）已超出截止时间
+        bool missesDeadline(const ExecutionContext &context, size_t index) const;
+
+        // 提交一个前驱已全部完成的节点，执行结束后递减后继的计数；
+        // 新就绪的第一个后继直接在当前线程继续执行，其余的才提交到线程池
+        void submitTask(std::shared_ptr<ExecutionContext> context, size_t index);
+        // 节点按任务类型所属的执行器
+        Executor &executorFor(const ExecutionContext &context, size_t index) const;
+        static constexpr size_t kNoTask = static_cast<size_t>(-1);
+        void runTask(const std::shared_ptr<ExecutionContext> &context, size_t index);
+        // 执行节点；处理函数被挂起时返回false，节点完成后在其执行器上调用resumeTask
+        bool executeTask(const std::shared_ptr<ExecutionContext> &context, size_t index);
+        void resumeTask(const std::shared_ptr<ExecutionContext> &context, size_t index);
+        void recordExecutionTime(const ExecutionContext &context, size_t index);
+
+        // 节点完成（执行、取消或剪枝）后的收尾：释放不再需要的前驱结果并推进后继，
+        // 输入边条件不满足的后继就地剪枝；返回应在当前线程继续执行的节点（与index属于同一执行器）
+        size_t finishTask(const std::shared_ptr<ExecutionContext> &context, size_t index);
+
+        std::shared_ptr<Executor> threadPool_;
+        std::shared_ptr<Executor> ioExecutor_; // TaskKind::Io节点的执行器，为空时使用threadPool_
+        std::vector<std::shared_ptr<TaskNode>> tasks_;         // 按任务序号索引
+        std::unordered_map<std::string, TaskId> taskIndices_;  // 名称到序号，仅构建阶段使用
+        std::shared_ptr<TaskTimeEstimates> timeEstimates_ = std::make_shared<TaskTimeEstimates>();
+        std::vector<std::atomic<double> *> expectedTimeMs_;    // 各任务在timeEstimates_中的估计值，按任务序号索引
+
+        DataObject::Clock::time_point deadline_ = DataObject::Clock::time_point::max();
+        bool cancelled_ = false;
 
-        ThreadPool threadPool_;
-        std::unordered_map<std::string, std::shared_ptr<TaskNode>> tasks_;
+        // compile生成的执行计划
+        TaskId compiledOutput_ = TaskNode::kInvalidTaskId;
+        std::shared_ptr<ExecutionContext> compiledContext_;
     };
 
 } // namespace GryFlux
\ No newline at end of file
@@ -17,69 +17,69 @@
 #pragma once
 
 #include <vector>
-#include <queue>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
-#include <functional>
-#include <future>
-#include <type_traits>
+#include <atomic>
+#include <stdexcept>
+#include "framework/executor.h"
 
 namespace GryFlux
 {
 
-    // 线程池实现
-    class ThreadPool
+    // 线程池实现：所有工作线程共享一个任务队列
+    class ThreadPool : public Executor
     {
     public:
-        explicit ThreadPool(size_t numThreads);
-        ~ThreadPool();
+        // 工作线程启动时按affinity绑定CPU并应用调度策略policy，默认都不修改
+        explicit ThreadPool(size_t numThreads, const CpuAffinity &affinity = CpuAffinity::any(),
+                            const ThreadPolicy &policy = ThreadPolicy());
+        ~ThreadPool() override;
 
         // 禁止复制
         ThreadPool(const ThreadPool &) = delete;
         ThreadPool &operator=(const ThreadPool &) = delete;
 
-        // 提交任务到线程池
-        template <class F>
-        auto enqueue(F &&f) -> std::future<typename std::result_of<F()>::type>
+        // 获取线程池中的线程数量
+        size_t getThreadCount() const override
         {
-            using return_type = typename std::result_of<F()>::type;
+            return workers_.size();
+        }
 
-            auto task = std::make_shared<std::packaged_task<return_type()>>(std::forward<F>(f));
-            std::future<return_type> res = task->get_future();
+        // 获取当前待处理任务数量
+        size_t getTaskCount() const override
+        {
+            std::unique_lock<std::mutex> lock(queueMutex_);
+            return tasks_.size();
+        }
+
+        bool isThreadPolicyGranted() const override
+        {
+            return policyDenied_.load() == 0;
+        }
 
+    protected:
+        // 提交任务到线程池
+        void post(InplaceTask task, uint64_t priority) override
+        {
             {
                 std::unique_lock<std::mutex> lock(queueMutex_);
                 if (stop_)
                 {
                     throw std::runtime_error("enqueue on stopped ThreadPool");
                 }
-                tasks_.emplace([task]()
-                               { (*task)(); });
+                tasks_.push(std::move(task), priority);
             }
 
             condition_.notify_one();
-            return res;
-        }
-
-        // 获取线程池中的线程数量
-        size_t getThreadCount() const
-        {
-            return workers_.size();
-        }
-
-        // 获取当前待处理任务数量
-        size_t getTaskCount() const
-        {
-            std::unique_lock<std::mutex> lock(queueMutex_);
-            return tasks_.size();
         }
 
     private:
         std::vector<std::thread> workers_;
-        std::queue<std::function<void()>> tasks_;
+        TaskQueue tasks_; // 任务槽位出队后复用，带优先级的任务先执行
         mutable std::mutex queueMutex_;
         std::condition_variable condition_;
         bool stop_;
+        std::atomic<size_t> policyDenied_{0}; // 未获得请求调度策略的工作线程数
     };
-}
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "framework/executor.h"
+
+namespace GryFlux
+{
+
+    // 工作窃取线程池：每个工作线程拥有本地双端队列，本地任务按LIFO执行，
+    // 本地队列为空时随机选择其他线程从队首窃取，避免所有线程争用同一把锁
+    class WorkStealingThreadPool : public Executor
+    {
+    public:
+        // 工作线程启动时按affinity绑定CPU并应用调度策略policy，默认都不修改
+        explicit WorkStealingThreadPool(size_t numThreads, const CpuAffinity &affinity = CpuAffinity::any(),
+                                        const ThreadPolicy &policy = ThreadPolicy());
+        ~WorkStealingThreadPool() override;
+
+        // 禁止复制
+        WorkStealingThreadPool(const WorkStealingThreadPool &) = delete;
+        WorkStealingThreadPool &operator=(const WorkStealingThreadPool &) = delete;
+
+        // 获取线程池中的线程数量
+        size_t getThreadCount() const override
+        {
+            return workers_.size();
+        }
+
+        // 获取当前待处理任务数量
+        size_t getTaskCount() const override
+        {
+            return pendingTasks_.load(std::memory_order_relaxed);
+        }
+
+        bool isThreadPolicyGranted() const override
+        {
+            return policyDenied_.load() == 0;
+        }
+
+    protected:
+        // 工作线程内提交的任务进入本线程队列尾部，外部线程提交的任务轮询分发
+        void post(InplaceTask task, uint64_t priority) override;
+
+    private:
+        // 每个工作线程的本地队列，锁仅在窃取时才会出现竞争
+        struct WorkQueue
+        {
+            std::mutex mutex;
+            TaskQueue tasks; // 带优先级的任务在本地与窃取时都先被取出
+        };
+
+        void workerLoop(size_t index, CpuAffinity affinity, ThreadPolicy policy);
+        bool popLocal(size_t index, InplaceTask &task);
+        bool steal(size_t thief, InplaceTask &task);
+
+        std::vector<std::thread> workers_;
+        std::vector<std::unique_ptr<WorkQueue>> queues_;
+        std::atomic<size_t> pendingTasks_;
+        std::atomic<size_t> nextQueue_;
+
+        // 空闲线程休眠与唤醒
+        std::mutex sleepMutex_;
+        std::condition_variable sleepCondition_;
+        std::atomic<size_t> idleWorkers_;
+        std::atomic<bool> stop_;
+        std::atomic<size_t> policyDenied_{0}; // 未获得请求调度策略的工作线程数
+    };
+
+} // namespace GryFlux
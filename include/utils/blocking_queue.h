@@ -0,0 +1,63 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+// 阻塞队列接口：threadsafe_queue（互斥锁）、mpmc_queue与spsc_queue（无锁环形缓冲区）共用，
+// 使用方可以按场景选择实现。close()之后入队失败，已入队的数据仍可取出
+template <typename T>
+class blocking_queue
+{
+public:
+    virtual ~blocking_queue() = default;
+
+    // 入队：threadsafe_queue不检查容量与关闭状态；
+    // 无锁实现容量固定，队列满时等待空位，队列关闭后丢弃数据
+    virtual void push(const T &data) = 0;
+    // 队列未满且未关闭时入队，否则立即返回false
+    virtual bool try_push(const T &data) = 0;
+    // 阻塞等待空位后入队，队列关闭时返回false
+    virtual bool push_wait(const T &data) = 0;
+    // 批量入队，语义同push，整批只加一次锁、只通知一次
+    virtual void push_bulk(const T *values, size_t count) = 0;
+
+    // 阻塞等待数据
+    virtual void wait_and_pop(T &value) = 0;
+    // 阻塞等待数据，队列关闭且已取空时返回false
+    virtual bool pop_wait(T &value) = 0;
+    // 最多等待timeout，超时或队列关闭且已取空时返回false
+    virtual bool pop_wait(T &value, std::chrono::milliseconds timeout) = 0;
+    // 非阻塞获取数据
+    virtual bool try_pop(T &value) = 0;
+    // 非阻塞批量出队，最多取maxCount个，返回实际取出的数量
+    virtual size_t try_pop_bulk(T *values, size_t maxCount) = 0;
+    // 最多等待timeout直到有数据，再批量取出最多maxCount个；超时或队列关闭且已取空时返回0
+    virtual size_t pop_wait_bulk(T *values, size_t maxCount, std::chrono::milliseconds timeout) = 0;
+
+    // 关闭队列并唤醒所有等待的线程
+    virtual void close() = 0;
+    // 重新打开已关闭的队列
+    virtual void reopen() = 0;
+    virtual bool closed() const = 0;
+
+    virtual bool empty() const = 0;
+    virtual size_t size() const = 0;
+    // 容量，0表示不限
+    virtual size_t capacity() const = 0;
+};
@@ -0,0 +1,80 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace GryFlux
+{
+
+    // CPU拓扑：按cpu_capacity（缺失时按cpuinfo_max_freq）区分大小核，首次使用时检测一次。
+    // 性能最低一档的核心为小核，其余为大核；各核心性能相同或无法读取时视为同构，大小核都等于全部CPU
+    class CpuTopology
+    {
+    public:
+        // 获取检测结果单例
+        static const CpuTopology &getInstance();
+
+        const std::vector<int> &getCpus() const { return cpus_; } // 所有在线CPU
+        const std::vector<int> &getBigCores() const { return bigCores_; }
+        const std::vector<int> &getLittleCores() const { return littleCores_; }
+        bool isHeterogeneous() const { return heterogeneous_; }
+
+        // 例如 "big: 4-7, little: 0-3"，用于日志
+        std::string describe() const;
+
+    private:
+        CpuTopology();
+
+        std::vector<int> cpus_;
+        std::vector<int> bigCores_;
+        std::vector<int> littleCores_;
+        bool heterogeneous_ = false;
+    };
+
+    // 工作线程的CPU亲和性配置
+    struct CpuAffinity
+    {
+        enum class Mode
+        {
+            Any,         // 不限制（默认），由系统调度
+            BigCores,    // 绑定到大核，适合预处理、推理后处理等计算密集的任务
+            LittleCores, // 绑定到小核，适合读写文件、网络收发等I/O任务
+            CpuList      // 绑定到cpus中列出的CPU
+        };
+
+        Mode mode = Mode::Any;
+        std::vector<int> cpus;
+
+        static CpuAffinity any() { return {Mode::Any, {}}; }
+        static CpuAffinity bigCores() { return {Mode::BigCores, {}}; }
+        static CpuAffinity littleCores() { return {Mode::LittleCores, {}}; }
+        static CpuAffinity cpuList(std::vector<int> list) { return {Mode::CpuList, std::move(list)}; }
+
+        // 解析为CPU编号列表，Any时为空
+        std::vector<int> resolve() const;
+
+        // 未指定线程数时的默认工作线程数：绑定的CPU数量，Any或解析结果为空时为硬件线程数（至少为1），
+        // 避免绑定到部分核心时线程数超过核心数
+        size_t defaultThreadCount() const;
+
+        // 把调用线程绑定到解析出的CPU上，Any时不做修改；失败时记录警告并返回false
+        bool applyToCurrentThread() const;
+    };
+
+} // namespace GryFlux
@@ -0,0 +1,418 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable> // NOLINT
+#include <cstddef>
+#include <memory>
+#include <mutex> // NOLINT
+#include <stdexcept>
+#include <utility>
+#include "utils/blocking_queue.h"
+
+// 无锁有界环形缓冲区通道。入队、出队在快速路径上只做原子操作，不加锁、不分配内存，
+// size()/empty()只读取两端的位置计数。只有队列满或空需要等待时才进入互斥锁与条件变量
+
+// 缓存行大小，用于隔开生产者与消费者各自频繁修改的数据
+constexpr size_t kQueueCacheLine = 64;
+
+// 等待事件：没有等待者时通知只需一次原子读取，不加锁
+class queue_event
+{
+public:
+    // 在修改队列状态之后调用
+    void notify_one()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_relaxed) > 0)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            condition_.notify_one();
+        }
+    }
+
+    void notify_all()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_relaxed) > 0)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            condition_.notify_all();
+        }
+    }
+
+    // 等待ready()返回true。ready在持有锁时求值，可以带有出队或入队的副作用；
+    // 登记等待者之后再检查一次，与notify_one配合不会丢失唤醒
+    template <typename Predicate>
+    void wait(Predicate ready)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        waiters_.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        condition_.wait(lock, ready);
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // 超时返回false
+    template <typename Predicate>
+    bool wait_for(std::chrono::milliseconds timeout, Predicate ready)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        waiters_.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        bool result = condition_.wait_for(lock, timeout, ready);
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+        return result;
+    }
+
+private:
+    std::atomic<int> waiters_{0};
+    std::mutex mutex_;
+    std::condition_variable condition_;
+};
+
+// 多生产者多消费者环形缓冲区（每个单元带序号，生产者与消费者各自CAS推进位置）。
+// 序号为 位置×2，最低位表示单元已写入：等待位置pos写入时为pos×2，写入后为pos×2+1，
+// 读出后为(pos+容量)×2。序号不随容量变化而重叠，容量为1时也能区分“已满”与“可写”
+template <typename T>
+class mpmc_ring
+{
+public:
+    explicit mpmc_ring(size_t capacity)
+        : capacity_(capacity), cells_(new Cell[capacity])
+    {
+        for (size_t i = 0; i < capacity_; ++i)
+        {
+            cells_[i].sequence.store(i << 1, std::memory_order_relaxed);
+        }
+    }
+
+    bool enqueue(const T &data)
+    {
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Cell &cell = cells_[pos % capacity_];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence - (pos << 1));
+            if (diff == 0)
+            {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    cell.data = data;
+                    cell.sequence.store((pos << 1) | 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false; // 已满
+            }
+            else
+            {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool dequeue(T &value)
+    {
+        size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Cell &cell = cells_[pos % capacity_];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence - ((pos << 1) | 1));
+            if (diff == 0)
+            {
+                if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    value = std::move(cell.data);
+                    cell.data = T(); // 立即释放单元持有的资源
+                    cell.sequence.store((pos + capacity_) << 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false; // 为空
+            }
+            else
+            {
+                pos = dequeuePos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    size_t size() const
+    {
+        size_t head = dequeuePos_.load(std::memory_order_acquire);
+        size_t tail = enqueuePos_.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    struct alignas(kQueueCacheLine) Cell
+    {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    const size_t capacity_;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(kQueueCacheLine) std::atomic<size_t> enqueuePos_{0};
+    alignas(kQueueCacheLine) std::atomic<size_t> dequeuePos_{0};
+};
+
+// 单生产者单消费者环形缓冲区：两端各自缓存对方的位置，只在看似满/空时才读取对方的原子变量
+template <typename T>
+class spsc_ring
+{
+public:
+    explicit spsc_ring(size_t capacity)
+        : capacity_(capacity), buffer_(new T[capacity]) {}
+
+    // 只能由同一时刻唯一的生产者调用
+    bool enqueue(const T &data)
+    {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cachedHead_ == capacity_)
+        {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail - cachedHead_ == capacity_)
+            {
+                return false; // 已满
+            }
+        }
+        buffer_[tail % capacity_] = data;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 只能由同一时刻唯一的消费者调用
+    bool dequeue(T &value)
+    {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cachedTail_)
+        {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head == cachedTail_)
+            {
+                return false; // 为空
+            }
+        }
+        T &slot = buffer_[head % capacity_];
+        value = std::move(slot);
+        slot = T();
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t size() const
+    {
+        size_t head = head_.load(std::memory_order_acquire);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    const size_t capacity_;
+    std::unique_ptr<T[]> buffer_;
+    // 消费者侧
+    alignas(kQueueCacheLine) std::atomic<size_t> head_{0};
+    size_t cachedTail_ = 0;
+    // 生产者侧
+    alignas(kQueueCacheLine) std::atomic<size_t> tail_{0};
+    size_t cachedHead_ = 0;
+};
+
+// 在环形缓冲区之上提供blocking_queue的阻塞、关闭语义
+template <typename T, typename Ring>
+class lockfree_queue : public blocking_queue<T>
+{
+public:
+    explicit lockfree_queue(size_t capacity) : ring_(checkCapacity(capacity)) {}
+
+    void push(const T &data) override
+    {
+        push_wait(data);
+    }
+
+    bool try_push(const T &data) override
+    {
+        if (closed_.load(std::memory_order_acquire) || !ring_.enqueue(data))
+            return false;
+        notEmpty_.notify_one();
+        return true;
+    }
+
+    bool push_wait(const T &data) override
+    {
+        if (try_push(data))
+            return true;
+
+        bool pushed = false;
+        notFull_.wait([&]
+                      { return closed_.load(std::memory_order_acquire) || (pushed = ring_.enqueue(data)); });
+        if (pushed)
+            notEmpty_.notify_one();
+        return pushed;
+    }
+
+    void push_bulk(const T *values, size_t count) override
+    {
+        if (closed_.load(std::memory_order_acquire))
+            return;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (ring_.enqueue(values[i]))
+                continue;
+
+            // 队列已满：先唤醒消费者取走已入队的部分，再等待空位
+            notEmpty_.notify_all();
+            bool pushed = false;
+            notFull_.wait([&]
+                          { return closed_.load(std::memory_order_acquire) || (pushed = ring_.enqueue(values[i])); });
+            if (!pushed)
+                return;
+        }
+        notEmpty_.notify_all();
+    }
+
+    void wait_and_pop(T &value) override
+    {
+        if (try_pop(value))
+            return;
+
+        notEmpty_.wait([&]
+                       { return ring_.dequeue(value); });
+        notFull_.notify_one();
+    }
+
+    bool pop_wait(T &value) override
+    {
+        if (try_pop(value))
+            return true;
+
+        bool popped = false;
+        notEmpty_.wait([&]
+                       { return (popped = ring_.dequeue(value)) || closed_.load(std::memory_order_acquire); });
+        if (popped)
+            notFull_.notify_one();
+        return popped;
+    }
+
+    bool pop_wait(T &value, std::chrono::milliseconds timeout) override
+    {
+        if (try_pop(value))
+            return true;
+
+        bool popped = false;
+        notEmpty_.wait_for(timeout, [&]
+                           { return (popped = ring_.dequeue(value)) || closed_.load(std::memory_order_acquire); });
+        if (popped)
+            notFull_.notify_one();
+        return popped;
+    }
+
+    bool try_pop(T &value) override
+    {
+        if (!ring_.dequeue(value))
+            return false;
+        notFull_.notify_one();
+        return true;
+    }
+
+    size_t try_pop_bulk(T *values, size_t maxCount) override
+    {
+        size_t count = dequeue_bulk(values, maxCount);
+        if (count > 0)
+            notFull_.notify_all();
+        return count;
+    }
+
+    size_t pop_wait_bulk(T *values, size_t maxCount, std::chrono::milliseconds timeout) override
+    {
+        if (maxCount == 0)
+            return 0;
+
+        size_t count = try_pop_bulk(values, maxCount);
+        if (count > 0)
+            return count;
+
+        notEmpty_.wait_for(timeout, [&]
+                           { return (count = dequeue_bulk(values, maxCount)) > 0 || closed_.load(std::memory_order_acquire); });
+        if (count > 0)
+            notFull_.notify_all();
+        return count;
+    }
+
+    void close() override
+    {
+        closed_.store(true, std::memory_order_seq_cst);
+        notEmpty_.notify_all();
+        notFull_.notify_all();
+    }
+
+    void reopen() override
+    {
+        closed_.store(false, std::memory_order_release);
+    }
+
+    bool closed() const override { return closed_.load(std::memory_order_acquire); }
+    bool empty() const override { return ring_.size() == 0; }
+    size_t size() const override { return ring_.size(); }
+    size_t capacity() const override { return ring_.capacity(); }
+
+private:
+    size_t dequeue_bulk(T *values, size_t maxCount)
+    {
+        size_t count = 0;
+        while (count < maxCount && ring_.dequeue(values[count]))
+            ++count;
+        return count;
+    }
+
+    static size_t checkCapacity(size_t capacity)
+    {
+        if (capacity == 0)
+        {
+            throw std::runtime_error("Lock-free queue requires a non-zero capacity");
+        }
+        return capacity;
+    }
+
+    Ring ring_;
+    alignas(kQueueCacheLine) std::atomic<bool> closed_{false};
+    queue_event notEmpty_; // 有数据或已关闭
+    queue_event notFull_;  // 有空位或已关闭
+};
+
+// 多生产者多消费者无锁队列
+template <typename T>
+using mpmc_queue = lockfree_queue<T, mpmc_ring<T>>;
+
+// 单生产者单消费者无锁队列：同一时刻只能有一个线程入队、一个线程出队
+template <typename T>
+using spsc_queue = lockfree_queue<T, spsc_ring<T>>;
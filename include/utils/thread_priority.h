@@ -21,17 +21,69 @@
  *************************************************************************************************************************/
 #pragma once
 
+#include <optional>
+#include <string>
+
 #ifdef _WIN32
 #include <Windows.h>
 #else
 #include <sched.h>
 #include <pthread.h>
+#include <unistd.h>
+#include <cstdio>
 #include <sys/sysinfo.h>
 #include <sys/resource.h>
 #include <sys/file.h>
 #endif
 
-void SetThreadPriorityToMaxLevel() noexcept {
+namespace GryFlux
+{
+
+    // 线程调度策略：实时调度类与优先级、nice值，以及可选的mlockall
+    struct ThreadPolicy
+    {
+        enum class Scheduler
+        {
+            Default,   // 保持继承的调度类（通常为SCHED_OTHER）
+            Fifo,      // SCHED_FIFO
+            RoundRobin // SCHED_RR
+        };
+
+        Scheduler scheduler = Scheduler::Default;
+        int priority = 0;        // 实时优先级，仅Fifo/RoundRobin有效，超出系统范围时截断
+        std::optional<int> nice; // 线程的nice值（-20~19），未设置时不修改
+        bool lockMemory = false; // mlockall(MCL_CURRENT | MCL_FUTURE)，作用于整个进程
+
+        static ThreadPolicy fifo(int priority) { return {Scheduler::Fifo, priority, std::nullopt, false}; }
+        static ThreadPolicy roundRobin(int priority) { return {Scheduler::RoundRobin, priority, std::nullopt, false}; }
+        static ThreadPolicy niceValue(int value) { return {Scheduler::Default, 0, value, false}; }
+
+        // 是否没有任何需要修改的项
+        bool isDefault() const { return scheduler == Scheduler::Default && !nice && !lockMemory; }
+
+        // 例如 "SCHED_FIFO:80 nice=-5 mlockall"，用于日志
+        std::string describe() const;
+    };
+
+    // applyThreadPolicy的结果：每一项请求是否生效，未请求的项视为生效
+    struct ThreadPolicyResult
+    {
+        bool schedulerGranted = true;
+        bool niceGranted = true;
+        bool memoryLocked = true;
+        std::string error; // 未生效项的原因，如权限不足
+
+        bool granted() const { return schedulerGranted && niceGranted && memoryLocked; }
+    };
+
+    // 把调度策略应用到调用线程；owner用于日志，未生效时记录警告（实时调度通常需要root或CAP_SYS_NICE）
+    ThreadPolicyResult applyThreadPolicy(const ThreadPolicy &policy, const std::string &owner);
+
+} // namespace GryFlux
+
+// 以下为全有或全无的旧接口：把当前线程或整个进程设为最高优先级，新代码请使用ThreadPolicy
+
+inline void SetThreadPriorityToMaxLevel() noexcept {
 #ifdef _WIN32
     SetThreadPriority(GetCurrentProcess(), THREAD_PRIORITY_TIME_CRITICAL);
 #else
@@ -42,7 +94,7 @@ void SetThreadPriorityToMaxLevel() noexcept {
 #endif
 }
 
-bool WriteAllBytes(const char* path, const void* data, int length) noexcept {
+inline bool WriteAllBytes(const char* path, const void* data, int length) noexcept {
     if (NULL == path || length < 0) {
         return false;
     }
@@ -65,7 +117,7 @@ bool WriteAllBytes(const char* path, const void* data, int length) noexcept {
     return true;
 }
  
-void SetProcessPriorityToMaxLevel() noexcept {
+inline void SetProcessPriorityToMaxLevel() noexcept {
 #ifdef _WIN32
     SetPriorityClass(GetCurrentProcess(), REALTIME_PRIORITY_CLASS);
 #else
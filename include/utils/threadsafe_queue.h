@@ -16,61 +16,193 @@
  *************************************************************************************************************************/
 #pragma once
 
+#include <chrono>
 #include <condition_variable> // NOLINT
+#include <cstddef>
 #include <memory>
 #include <mutex> // NOLINT
 #include <queue>
 #include <utility>
+#include "utils/blocking_queue.h"
 
+// 基于互斥锁的线程安全队列，同时可作为有界阻塞通道使用：
+// capacity为0时不限容量；close()之后push_wait/try_push失败，pop_wait取完剩余数据后返回false
 template <typename T>
-class threadsafe_queue
+class threadsafe_queue : public blocking_queue<T>
 {
 private:
     mutable std::mutex mutex_;
     std::queue<T> queue_;
-    std::condition_variable condition_;
+    std::condition_variable condition_; // 队列非空或已关闭
+    std::condition_variable notFull_;   // 队列未满或已关闭
+    size_t capacity_;
+    bool closed_ = false;
+
+    bool full() const { return capacity_ > 0 && queue_.size() >= capacity_; }
+
+    // 在持有mutex_时调用
+    T take()
+    {
+        T value = std::move(queue_.front());
+        queue_.pop();
+        if (capacity_ > 0)
+        {
+            notFull_.notify_one();
+        }
+        return value;
+    }
+
+    // 在持有mutex_时调用
+    size_t take_bulk(T *values, size_t maxCount)
+    {
+        size_t count = 0;
+        while (count < maxCount && !queue_.empty())
+        {
+            values[count++] = std::move(queue_.front());
+            queue_.pop();
+        }
+        if (count > 0 && capacity_ > 0)
+        {
+            notFull_.notify_all();
+        }
+        return count;
+    }
 
 public:
-    threadsafe_queue() {}
-    void push(const T &data)
+    explicit threadsafe_queue(size_t capacity = 0) : capacity_(capacity) {}
+
+    // 无条件入队，不检查容量与关闭状态
+    void push(const T &data) override
     {
         std::unique_lock<std::mutex> lock(mutex_);
         queue_.push(data);
         condition_.notify_one();
     }
 
+    // 队列未满且未关闭时入队，否则立即返回false
+    bool try_push(const T &data) override
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (closed_ || full())
+            return false;
+        queue_.push(data);
+        condition_.notify_one();
+        return true;
+    }
+
+    // 阻塞等待空位后入队，队列关闭时返回false
+    bool push_wait(const T &data) override
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notFull_.wait(lock, [this]
+                      { return closed_ || !full(); });
+        if (closed_)
+            return false;
+        queue_.push(data);
+        condition_.notify_one();
+        return true;
+    }
+
+    void push_bulk(const T *values, size_t count) override
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < count; ++i)
+            queue_.push(values[i]);
+        condition_.notify_all();
+    }
+
     // 阻塞等待数据
-    void wait_and_pop(T &value)
+    void wait_and_pop(T &value) override
     {
         std::unique_lock<std::mutex> lock(mutex_);
         condition_.wait(lock, [this]
                         { return !queue_.empty(); });
-        value = queue_.front();
-        queue_.pop();
+        value = take();
+    }
+
+    // 阻塞等待数据，队列关闭且已取空时返回false
+    bool pop_wait(T &value) override
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [this]
+                        { return closed_ || !queue_.empty(); });
+        if (queue_.empty())
+            return false;
+        value = take();
+        return true;
+    }
+
+    // 最多等待timeout，超时或队列关闭且已取空时返回false
+    bool pop_wait(T &value, std::chrono::milliseconds timeout) override
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!condition_.wait_for(lock, timeout, [this]
+                                 { return closed_ || !queue_.empty(); }) ||
+            queue_.empty())
+            return false;
+        value = take();
+        return true;
     }
 
     // 非阻塞获取数据
-    bool try_pop(T &value)
+    bool try_pop(T &value) override
     {
         std::unique_lock<std::mutex> lock(mutex_);
         if (queue_.empty())
             return false;
-        value = queue_.front();
-        queue_.pop();
+        value = take();
         return true;
     }
 
-    bool empty() const
+    size_t try_pop_bulk(T *values, size_t maxCount) override
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return take_bulk(values, maxCount);
+    }
+
+    size_t pop_wait_bulk(T *values, size_t maxCount, std::chrono::milliseconds timeout) override
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait_for(lock, timeout, [this]
+                            { return closed_ || !queue_.empty(); });
+        return take_bulk(values, maxCount);
+    }
+
+    // 关闭队列并唤醒所有等待的线程，已入队的数据仍可取出
+    void close() override
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        closed_ = true;
+        condition_.notify_all();
+        notFull_.notify_all();
+    }
+
+    // 重新打开已关闭的队列
+    void reopen() override
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        closed_ = false;
+    }
+
+    bool closed() const override
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return closed_;
+    }
+
+    bool empty() const override
     {
         std::unique_lock<std::mutex> lock(mutex_);
         return queue_.empty();
     }
 
-    int size() const
+    size_t size() const override
     {
         std::unique_lock<std::mutex> lock(mutex_);
         return queue_.size();
     }
 
+    size_t capacity() const override { return capacity_; }
+
     ~threadsafe_queue() {}
 };
@@ -91,7 +91,7 @@ void initLogger()
     LOG.setLogFileRoot("./logs");
 }
 
-int main(int argc, char **argv)
+int main()
 {
     initLogger();
 
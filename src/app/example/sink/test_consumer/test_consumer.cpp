@@ -23,32 +23,27 @@ namespace GryFlux
     {
         LOG.info("[TestConsumer] Consumer started");
 
-        // 只在生产者活跃时处理
-        while (shouldContinue())
-        {
-            std::shared_ptr<DataObject> output;
+        BatchDataConsumer::run();
+
+        LOG.info("[TestConsumer] Processed frames: %d", processedFrames);
+        LOG.info("[TestConsumer] Consumer finished");
+    }
 
-            if (getData(output))
+    void TestConsumer::consumeBatch(const std::shared_ptr<DataObject> *results, size_t count)
+    {
+        for (size_t n = 0; n < count; ++n)
+        {
+            auto result = std::dynamic_pointer_cast<CustomPackage>(results[n]);
+            if (result)
             {
-                auto result = std::dynamic_pointer_cast<CustomPackage>(output);
-                if (result)
+                std::vector<int> data;
+                result->get_data(data);
+                for (auto &i : data)
                 {
-                    std::vector<int> data;
-                    result->get_data(data);
-                    for (auto &i : data)
-                    {
-                        LOG.info("Frame %d processed, data: %d", processedFrames, i);
-                    }
-                    processedFrames++;
+                    LOG.info("Frame %d processed, data: %d", processedFrames, i);
                 }
-            }
-            else
-            {
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                processedFrames++;
             }
         }
-
-        LOG.info("[TestConsumer] Processed frames: %d", processedFrames);
-        LOG.info("[TestConsumer] Consumer finished");
     }
 };
@@ -23,14 +23,15 @@
 
 namespace GryFlux
 {
-    class TestConsumer : public DataConsumer
+    // 示例输出的每帧只有几个整数，按批取出以减少每帧的队列加锁次数
+    class TestConsumer : public BatchDataConsumer
     {
     private:
         int processedFrames;
 
     public:
         TestConsumer(StreamingPipeline &pipeline, std::atomic<bool> &running, CPUAllocator *allocator)
-            : DataConsumer(pipeline, running, allocator), processedFrames(0) {}
+            : BatchDataConsumer(pipeline, running, allocator), processedFrames(0) {}
 
         int getProcessedFrames() const
         {
@@ -39,5 +40,6 @@ namespace GryFlux
 
     protected:
         void run() override;
+        void consumeBatch(const std::shared_ptr<DataObject> *results, size_t count) override;
     };
 }
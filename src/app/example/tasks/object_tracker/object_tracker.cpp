@@ -25,11 +25,13 @@ namespace GryFlux
         if (inputs.size() != 2)
             return nullptr;
 
-        auto detection = std::dynamic_pointer_cast<CustomPackage>(inputs[0]);
         auto feature_res = std::dynamic_pointer_cast<CustomPackage>(inputs[1]);
 
-        // 默认输出为第一个输入，所有结果向第一个输入合并
-        auto result = std::dynamic_pointer_cast<CustomPackage>(inputs[0]);
+        // 默认输出为第一个输入，所有结果向第一个输入合并；
+        // 检测结果只有本任务读取时直接原地合并，否则在拷贝上合并，不修改其他节点仍在读取的数据
+        auto result = takeInput<CustomPackage>(inputs, 0);
+        if (!result || !feature_res)
+            return nullptr;
         // 添加处理逻辑
         std::vector<int> input_data;
         feature_res->get_data(input_data);
@@ -58,10 +58,6 @@ namespace GryFlux
                 cv::imwrite(file.string(), image);
                 LOG.info("[WriteConsumer] Frame %d written to %s", processedFrames_, file.string().c_str());
             }
-            else
-            {
-                std::this_thread::sleep_for(std::chrono::milliseconds(2));
-            }
         }
 
         LOG.info("[WriteConsumer] Processed %d frames", processedFrames_);
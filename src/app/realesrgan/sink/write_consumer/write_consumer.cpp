@@ -51,8 +51,6 @@ void WriteConsumer::run() {
             LOG.info("[RealESRGAN::WriteConsumer] Frame %d processed -> %s",
                      processed_frames_,
                      output_file.filename().string().c_str());
-        } else {
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
         }
     }
 
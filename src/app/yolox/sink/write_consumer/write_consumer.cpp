@@ -24,10 +24,6 @@ namespace GryFlux
                     LOG.info("Frame %d processed", processedFrames);
                 }
             }
-            else
-            {
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
-            }
         }
 
         LOG.info("[TestConsumer] Processed frames: %d", processedFrames);
@@ -167,10 +167,10 @@ namespace GryFlux
             LOG.info("Output cnt: %d, grid size: { %d }x{ %d }", output_cnt, grid_w, grid_h);
         }
         LOG.info("valid count: %d", valid);
-            // no object detect
+            // no object detect：输出Empty，下游按输入边条件跳过画框
         if (valid <= 0)
         {
-            return nullptr;
+            return TaskOutcome::empty();
         }
         std::vector<int> indexArray;
         for (int i = 0; i < valid; ++i)
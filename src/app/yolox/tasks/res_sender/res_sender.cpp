@@ -40,6 +40,12 @@ namespace GryFlux
         int img_id = image_data->get_id();
         auto img = image_data->get_data();
 
+        // 未检测到目标：原图直接送往输出，不做画框
+        if (inputs[1]->is<TaskOutcome>())
+        {
+            return std::make_shared<ImagePackage>(img, img_id);
+        }
+
         auto object_data = std::dynamic_pointer_cast<ObjectPackage>(inputs[1]);
         auto objects = object_data->get_data();
         int object_count = objects.size();
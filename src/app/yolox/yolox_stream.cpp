@@ -25,6 +25,7 @@
 #include <unordered_map>
 
 #include "framework/streaming_pipeline.h"
+#include "framework/graph_template.h"
 #include "framework/data_object.h"
 #include "framework/processing_task.h"
 
@@ -36,30 +37,27 @@
 #include "tasks/rk_runner/rk_runner.h"
 #include "tasks/res_sender/res_sender.h"
 #include "sink/write_consumer/write_consumer.h"
-// 计算图构建函数
-void buildStreamingComputeGraph(std::shared_ptr<GryFlux::PipelineBuilder> builder,
-                                std::shared_ptr<GryFlux::DataObject> input,
-                                const std::string &outputId,
-                                GryFlux::TaskRegistry &taskRegistry)
+// 计算图模板构建函数，只在启动时调用一次
+std::shared_ptr<GryFlux::GraphTemplate> buildComputeGraphTemplate(GryFlux::TaskRegistry &taskRegistry,
+                                                                  const std::string &outputId)
 {
+    auto graph = std::make_shared<GryFlux::GraphTemplate>();
+
     // 输入节点
-    auto inputNode = builder->addInput("input", input);
+    graph->addInput("input");
 
     // 使用注册表中的任务构建计算图
-    auto imgPreprocessNode = builder->addTask("imagePreprocess",
-                                              taskRegistry.getProcessFunction("imagePreprocess"),
-                                              {inputNode});
-    auto rkRunnerNode = builder->addTask("rkRunner",
-                                         taskRegistry.getProcessFunction("rkRunner"),
-                                         {imgPreprocessNode});
-    auto objectDetectorNode = builder->addTask("objectDetector",
-                                               taskRegistry.getProcessFunction("objectDetector"),
-                                               {imgPreprocessNode, rkRunnerNode});
-
-    builder->addTask(outputId,
-                     taskRegistry.getProcessFunction("resultSender"),
-                     {inputNode, objectDetectorNode});
-
+    graph->addTask("imagePreprocess", taskRegistry.getProcessFunction("imagePreprocess"), {"input"});
+    graph->addTask("rkRunner", taskRegistry.getProcessFunction("rkRunner"), {"imagePreprocess"});
+    graph->addTask("objectDetector", taskRegistry.getProcessFunction("objectDetector"), {"imagePreprocess", "rkRunner"});
+    // 未检测到目标的帧由objectDetector输出Empty，resultSender接受Empty并直接输出原图
+    graph->addTask(outputId, taskRegistry.getProcessFunction("resultSender"), {"input", "objectDetector"},
+                   {GryFlux::EdgeCondition::OnValue, GryFlux::EdgeCondition::OnValue | GryFlux::EdgeCondition::OnEmpty});
+    // 输出节点把结果交给写文件的消费者，标记为I/O节点，在I/O执行器上执行，不占用计算线程
+    graph->setTaskKind(outputId, GryFlux::TaskKind::Io);
+
+    graph->compile(outputId);
+    return graph;
 }
 
 void initLogger()
@@ -95,28 +93,23 @@ int main(int argc, const char **argv)
     GryFlux::TaskRegistry taskRegistry;
 
     CPUAllocator *cpuAllocator = new CPUAllocator();
-    // 注册各种处理任务
-    taskRegistry.registerTask<GryFlux::ImagePreprocess>("imagePreprocess", 640, 640);
+    // 注册各种处理任务：无状态的CPU任务允许多帧同时调用，
+    // RkRunner持有rknn_context与固定的输入输出内存，保持串行调用
+    taskRegistry.registerTask<GryFlux::ImagePreprocess>("imagePreprocess", GryFlux::TaskConcurrency::unlimited(), 640, 640);
     taskRegistry.registerTask<GryFlux::RkRunner>("rkRunner", argv[1]);
-    taskRegistry.registerTask<GryFlux::ObjectDetector>("objectDetector", 0.5f);
-    taskRegistry.registerTask<GryFlux::ResSender>("resultSender");
-    // 创建流式处理管道
-    GryFlux::StreamingPipeline pipeline(10); // 使用10个线程
-    // 设置输出节点ID
-    pipeline.setOutputNodeId("resultSender");
-
+    taskRegistry.registerTask<GryFlux::ObjectDetector>("objectDetector", GryFlux::TaskConcurrency::unlimited(), 0.5f);
+    taskRegistry.registerTask<GryFlux::ResSender>("resultSender", GryFlux::TaskConcurrency::unlimited());
+    // 创建流式处理管道，计算线程数等于核心数，最多4帧同时在途，
+    // 使后一帧的预处理与前一帧的推理重叠执行；工作窃取线程池避免多个线程争用同一队列锁
+    GryFlux::StreamingPipeline pipeline(0, 100, 4, GryFlux::ThreadPoolType::WorkStealing);
+    // 只有输出节点是I/O节点，I/O执行器只需少量线程，绑定到小核并调低优先级，大核留给计算线程
+    pipeline.setIoExecutor(GryFlux::createIoThreadPool(2, GryFlux::CpuAffinity::littleCores(),
+                                                       GryFlux::ThreadPolicy::niceValue(5)));
     // 启用性能分析
     pipeline.enableProfiling(true);
 
-    // 设置输出节点ID
-
-    // 设置处理函数
-    pipeline.setProcessor([&taskRegistry](std::shared_ptr<GryFlux::PipelineBuilder> builder,
-                                          std::shared_ptr<GryFlux::DataObject> input,
-                                          const std::string &outputId)
-                          {
-        // 调用命名函数
-        buildStreamingComputeGraph(builder, input, outputId, taskRegistry); });
+    // 设置计算图模板，输出节点ID取自模板
+    pipeline.setGraphTemplate(buildComputeGraphTemplate(taskRegistry, "resultSender"));
 
     // 启动管道
     pipeline.start();
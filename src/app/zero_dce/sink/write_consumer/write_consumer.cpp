@@ -54,8 +54,6 @@ void WriteConsumer::run() {
 
       LOG.info("[ZeroDCE::WriteConsumer] Frame %d processed -> %s",
                processed_frames_, output_file.filename().string().c_str());
-    } else {
-      std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
   }
 
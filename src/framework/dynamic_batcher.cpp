@@ -0,0 +1,356 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#include "framework/dynamic_batcher.h"
+#include "framework/exclusive_inputs.h"
+#include "utils/logger.h"
+#include <algorithm>
+#include <future>
+#include <stdexcept>
+
+namespace GryFlux
+{
+
+    DynamicBatcher::DynamicBatcher(BatchFunction func, size_t maxBatchSize, std::chrono::microseconds maxWait)
+        : func_(std::move(func)), maxBatchSize_(std::max<size_t>(maxBatchSize, 1)), maxWait_(maxWait)
+    {
+        if (!func_)
+        {
+            throw std::runtime_error("Batch function is null");
+        }
+        timer_ = std::thread(&DynamicBatcher::timerLoop, this);
+    }
+
+    DynamicBatcher::~DynamicBatcher()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        timerCondition_.notify_all();
+        if (timer_.joinable())
+        {
+            timer_.join();
+        }
+    }
+
+    std::shared_ptr<DataObject> DynamicBatcher::process(const Inputs &inputs)
+    {
+        auto promise = std::make_shared<std::promise<std::shared_ptr<DataObject>>>();
+        auto future = promise->get_future();
+        Completion done = [promise](std::shared_ptr<DataObject> result, std::exception_ptr error)
+        {
+            if (error)
+            {
+                promise->set_exception(error);
+            }
+            else
+            {
+                promise->set_value(std::move(result));
+            }
+        };
+
+        std::shared_ptr<Batch> ready;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            enqueueCall(Call{inputs, std::move(done), nullptr, TaskQueue::kNoPriority});
+            ready = takeReadyBatch();
+        }
+        if (ready)
+        {
+            submitBatch(std::move(ready));
+        }
+        return future.get();
+    }
+
+    bool DynamicBatcher::invoke(const Inputs &inputs, std::shared_ptr<DataObject> &,
+                                Executor &executor, uint64_t priority, Completion done)
+    {
+        std::shared_ptr<Batch> ready;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            enqueueCall(Call{inputs, std::move(done), &executor, priority});
+            ready = takeReadyBatch();
+        }
+        if (ready)
+        {
+            submitBatch(std::move(ready));
+        }
+        return false;
+    }
+
+    void DynamicBatcher::enqueueCall(Call call)
+    {
+        if (!openBatch_)
+        {
+            openBatch_ = std::make_shared<Batch>();
+            openBatch_->calls.reserve(maxBatchSize_);
+            openBatch_->deadline = std::chrono::steady_clock::now() + maxWait_;
+            timerCondition_.notify_one();
+        }
+        openBatch_->calls.push_back(std::move(call));
+
+        if (openBatch_->calls.size() >= batchTarget() || maxWait_.count() <= 0)
+        {
+            // 批次已满或已不会再有帧加入，后续调用进入新批次
+            closeOpenBatch();
+        }
+    }
+
+    void DynamicBatcher::closeOpenBatch()
+    {
+        auto batch = std::move(openBatch_);
+        openBatch_.reset();
+
+        // 批次在最后加入的调用所属的执行器上执行，优先级取各调用中最高的（数值最小）
+        batch->executor = batch->calls.back().executor;
+        batch->priority = TaskQueue::kNoPriority;
+        for (const auto &call : batch->calls)
+        {
+            batch->priority = std::min(batch->priority, call.priority);
+        }
+        readyBatches_.push_back(std::move(batch));
+    }
+
+    std::shared_ptr<DynamicBatcher::Batch> DynamicBatcher::takeReadyBatch()
+    {
+        if (running_ || readyBatches_.empty())
+        {
+            return nullptr;
+        }
+        running_ = true;
+        auto batch = std::move(readyBatches_.front());
+        readyBatches_.pop_front();
+        return batch;
+    }
+
+    void DynamicBatcher::submitBatch(std::shared_ptr<Batch> batch)
+    {
+        Executor *executor = batch->executor;
+        if (executor)
+        {
+            try
+            {
+                executor->dispatch([this, batch]()
+                                   { runBatches(batch, batch->executor); },
+                                   batch->priority);
+                return;
+            }
+            catch (const std::exception &e)
+            {
+                LOG.warning("[DynamicBatcher] Failed to submit batch, running inline: %s", e.what());
+            }
+        }
+        runBatches(std::move(batch), nullptr);
+    }
+
+    void DynamicBatcher::runBatches(std::shared_ptr<Batch> batch, Executor *current)
+    {
+        while (batch)
+        {
+            runBatch(*batch);
+
+            // 执行期间封闭的批次接着执行，设备不等待结果分发
+            std::shared_ptr<Batch> next;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (readyBatches_.empty())
+                {
+                    running_ = false;
+                }
+                else
+                {
+                    next = std::move(readyBatches_.front());
+                    readyBatches_.pop_front();
+                }
+            }
+            if (next && next->executor && next->executor != current)
+            {
+                submitBatch(std::move(next));
+                next.reset();
+            }
+
+            // 还有批次要在当前线程执行时，所有结果都分发出去
+            completeBatch(batch, current, !next);
+            batch = std::move(next);
+        }
+    }
+
+    void DynamicBatcher::runBatch(Batch &batch)
+    {
+        std::vector<Inputs> items;
+        items.reserve(batch.calls.size());
+        for (auto &call : batch.calls)
+        {
+            items.push_back(std::move(call.inputs));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            // 只统计已执行的批次，仍在接收调用的批次不计入平均批大小
+            calls_ += items.size();
+            batches_++;
+            if (items.size() >= batchTarget())
+            {
+                fullBatches_++;
+            }
+        }
+
+        try
+        {
+            // 批次合并了多帧的输入，不沿用某一帧的独占输入
+            ExclusiveInputs::Scope exclusive(0);
+            batch.results = func_(items);
+            if (batch.results.size() != items.size())
+            {
+                throw std::runtime_error("Batch function returned " + std::to_string(batch.results.size()) +
+                                         " results for " + std::to_string(items.size()) + " inputs");
+            }
+        }
+        catch (...)
+        {
+            batch.error = std::current_exception();
+        }
+        LOG.debug("[DynamicBatcher] Executed batch of %zu", items.size());
+    }
+
+    void DynamicBatcher::completeBatch(const std::shared_ptr<Batch> &batch, Executor *current, bool allowInline)
+    {
+        // 当前执行器上的最后一个调用留在本线程继续，其余的提交到各自的执行器
+        constexpr size_t kNone = static_cast<size_t>(-1);
+        size_t inlineIndex = kNone;
+        if (allowInline && current)
+        {
+            for (size_t i = 0; i < batch->calls.size(); ++i)
+            {
+                if (batch->calls[i].executor == current)
+                {
+                    inlineIndex = i;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < batch->calls.size(); ++i)
+        {
+            const auto &call = batch->calls[i];
+            if (i == inlineIndex)
+            {
+                continue;
+            }
+            if (!call.executor)
+            {
+                // 同步调用只需唤醒等待的线程
+                completeCall(*batch, i);
+                continue;
+            }
+            try
+            {
+                call.executor->dispatch([this, batch, i]()
+                                        { completeCall(*batch, i); },
+                                        call.priority);
+            }
+            catch (const std::exception &e)
+            {
+                LOG.warning("[DynamicBatcher] Failed to resume batched call, running inline: %s", e.what());
+                completeCall(*batch, i);
+            }
+        }
+        if (inlineIndex != kNone)
+        {
+            completeCall(*batch, inlineIndex);
+        }
+    }
+
+    void DynamicBatcher::completeCall(const Batch &batch, size_t index)
+    {
+        const auto &call = batch.calls[index];
+        call.done(batch.error ? nullptr : batch.results[index], batch.error);
+    }
+
+    void DynamicBatcher::timerLoop()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopping_)
+        {
+            if (!openBatch_)
+            {
+                timerCondition_.wait(lock);
+                continue;
+            }
+            auto deadline = openBatch_->deadline;
+            if (std::chrono::steady_clock::now() < deadline)
+            {
+                timerCondition_.wait_until(lock, deadline);
+                continue;
+            }
+
+            closeOpenBatch();
+            auto ready = takeReadyBatch();
+            if (ready)
+            {
+                lock.unlock();
+                submitBatch(std::move(ready));
+                lock.lock();
+            }
+        }
+    }
+
+    void DynamicBatcher::addCallers(size_t count)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        maxCallers_ += count;
+    }
+
+    void DynamicBatcher::removeCallers(size_t count)
+    {
+        std::shared_ptr<Batch> ready;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            maxCallers_ -= std::min(count, maxCallers_);
+            // 同时调用的帧数变少后，正在接收的批次可能已经凑满
+            if (openBatch_ && openBatch_->calls.size() >= batchTarget())
+            {
+                closeOpenBatch();
+                ready = takeReadyBatch();
+            }
+        }
+        if (ready)
+        {
+            submitBatch(std::move(ready));
+        }
+    }
+
+    size_t DynamicBatcher::batchTarget() const
+    {
+        return maxCallers_ > 0 ? std::min(maxBatchSize_, maxCallers_) : maxBatchSize_;
+    }
+
+    DynamicBatcher::Stats DynamicBatcher::getStats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Stats stats;
+        stats.calls = calls_;
+        stats.batches = batches_;
+        stats.fullBatches = fullBatches_;
+        if (batches_ > 0)
+        {
+            stats.meanBatchSize = static_cast<double>(calls_) / batches_;
+            stats.hitRate = static_cast<double>(fullBatches_) / batches_;
+        }
+        return stats;
+    }
+
+} // namespace GryFlux
@@ -0,0 +1,44 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#include "framework/executor.h"
+#include "framework/thread_pool.h"
+#include "framework/work_stealing_thread_pool.h"
+
+namespace GryFlux
+{
+
+    std::shared_ptr<Executor> createThreadPool(size_t numThreads, ThreadPoolType type, const CpuAffinity &affinity,
+                                               const ThreadPolicy &policy)
+    {
+        if (type == ThreadPoolType::WorkStealing)
+        {
+            return std::make_shared<WorkStealingThreadPool>(numThreads, affinity, policy);
+        }
+        return std::make_shared<ThreadPool>(numThreads, affinity, policy);
+    }
+
+    std::shared_ptr<Executor> createIoThreadPool(size_t numThreads, const CpuAffinity &affinity,
+                                                 const ThreadPolicy &policy)
+    {
+        if (numThreads == 0)
+        {
+            numThreads = affinity.defaultThreadCount() * kIoThreadsPerCore;
+        }
+        return createThreadPool(numThreads, ThreadPoolType::SharedQueue, affinity, policy);
+    }
+
+} // namespace GryFlux
@@ -0,0 +1,159 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#include "framework/graph_template.h"
+#include "utils/logger.h"
+#include <stdexcept>
+
+namespace GryFlux
+{
+
+    void GraphTemplate::checkMutable() const
+    {
+        if (compiled_)
+        {
+            throw std::runtime_error("Cannot modify a compiled graph template");
+        }
+    }
+
+    void GraphTemplate::addInput(const std::string &id)
+    {
+        checkMutable();
+        if (hasInput_)
+        {
+            throw std::runtime_error("Graph template already has an input node: " + nodes_[inputIndex_].id);
+        }
+        if (indices_.count(id))
+        {
+            throw std::runtime_error("Duplicate node id in graph template: " + id);
+        }
+
+        inputIndex_ = nodes_.size();
+        hasInput_ = true;
+        indices_[id] = nodes_.size();
+        nodes_.push_back({id, nullptr, {}, {}});
+    }
+
+    void GraphTemplate::addTask(const std::string &id, ProcessFunction func, const std::vector<std::string> &inputs,
+                                const std::vector<EdgeCondition> &conditions)
+    {
+        checkMutable();
+        if (indices_.count(id))
+        {
+            throw std::runtime_error("Duplicate node id in graph template: " + id);
+        }
+        if (!func)
+        {
+            throw std::runtime_error("Process function is null for node: " + id);
+        }
+        if (inputs.empty())
+        {
+            throw std::runtime_error("Task node has no inputs: " + id);
+        }
+        if (!conditions.empty() && conditions.size() != inputs.size())
+        {
+            throw std::runtime_error("Edge condition count does not match input count for node: " + id);
+        }
+
+        NodeSpec spec{id, std::move(func), {}, conditions};
+        spec.conditions.resize(inputs.size(), EdgeCondition::OnValue);
+        for (const auto &input : inputs)
+        {
+            auto it = indices_.find(input);
+            if (it == indices_.end())
+            {
+                throw std::runtime_error("Unknown input [" + input + "] for node: " + id);
+            }
+            spec.inputs.push_back(it->second);
+        }
+
+        indices_[id] = nodes_.size();
+        nodes_.push_back(std::move(spec));
+    }
+
+    void GraphTemplate::setTaskKind(const std::string &id, TaskKind kind)
+    {
+        checkMutable();
+        auto it = indices_.find(id);
+        if (it == indices_.end())
+        {
+            throw std::runtime_error("Unknown node in graph template: " + id);
+        }
+        nodes_[it->second].kind = kind;
+    }
+
+    void GraphTemplate::compile(const std::string &outputId)
+    {
+        checkMutable();
+        if (!hasInput_)
+        {
+            throw std::runtime_error("Graph template has no input node");
+        }
+        auto outputIt = indices_.find(outputId);
+        if (outputIt == indices_.end())
+        {
+            throw std::runtime_error("Output node not found in graph template: " + outputId);
+        }
+
+        // 节点按添加顺序排列即为拓扑序，逆序传播可达性即可找出输出节点依赖的全部节点
+        std::vector<bool> reachable(nodes_.size(), false);
+        reachable[outputIt->second] = true;
+        for (size_t i = nodes_.size(); i-- > 0;)
+        {
+            if (!reachable[i])
+            {
+                continue;
+            }
+            for (size_t input : nodes_[i].inputs)
+            {
+                reachable[input] = true;
+            }
+        }
+        if (!reachable[inputIndex_])
+        {
+            throw std::runtime_error("Output node [" + outputId + "] does not depend on the input node");
+        }
+
+        // 裁剪不可达节点并重新编号
+        std::vector<size_t> remap(nodes_.size(), 0);
+        std::vector<NodeSpec> compiled;
+        for (size_t i = 0; i < nodes_.size(); ++i)
+        {
+            if (!reachable[i])
+            {
+                LOG.warning("Node [%s] is not reachable from output [%s], pruned", nodes_[i].id.c_str(), outputId.c_str());
+                continue;
+            }
+            remap[i] = compiled.size();
+            compiled.push_back(std::move(nodes_[i]));
+            for (auto &input : compiled.back().inputs)
+            {
+                input = remap[input];
+            }
+        }
+
+        nodes_ = std::move(compiled);
+        indices_.clear();
+        for (size_t i = 0; i < nodes_.size(); ++i)
+        {
+            indices_[nodes_[i].id] = i;
+        }
+        inputIndex_ = remap[inputIndex_];
+        outputId_ = outputId;
+        compiled_ = true;
+    }
+
+} // namespace GryFlux
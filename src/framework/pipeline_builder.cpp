@@ -18,12 +18,17 @@
 #include "utils/logger.h"
 #include <chrono>
 #include <iostream>
+#include <stdexcept>
 #include <unordered_map>
 
 namespace GryFlux
 {
 
-    PipelineBuilder::PipelineBuilder(size_t numThreads) : scheduler_(std::make_shared<TaskScheduler>(numThreads)) {}
+    PipelineBuilder::PipelineBuilder(size_t numThreads, ThreadPoolType poolType)
+        : scheduler_(std::make_shared<TaskScheduler>(numThreads, poolType)) {}
+
+    PipelineBuilder::PipelineBuilder(std::shared_ptr<Executor> threadPool)
+        : scheduler_(std::make_shared<TaskScheduler>(threadPool)) {}
 
     std::shared_ptr<TaskNode> PipelineBuilder::addInput(const std::string &id, std::shared_ptr<DataObject> data)
     {
@@ -35,15 +40,31 @@ namespace GryFlux
     std::shared_ptr<TaskNode> PipelineBuilder::addTask(
         const std::string &id,
         std::function<std::shared_ptr<DataObject>(const std::vector<std::shared_ptr<DataObject>> &)> func,
-        const std::vector<std::shared_ptr<TaskNode>> &inputs)
+        const std::vector<std::shared_ptr<TaskNode>> &inputs,
+        const std::vector<EdgeCondition> &conditions)
     {
+        if (!conditions.empty() && conditions.size() != inputs.size())
+        {
+            throw std::runtime_error("Edge condition count does not match input count for task: " + id);
+        }
 
-        auto node = std::make_shared<MultiInputTaskNode>(id, func, inputs);
+        auto node = std::make_shared<MultiInputTaskNode>(id, func, inputs, conditions);
         scheduler_->addTask(node);
         return node;
     }
 
     std::shared_ptr<DataObject> PipelineBuilder::execute(const std::string &outputId)
+    {
+        auto id = scheduler_->findTaskId(outputId);
+        if (id == TaskNode::kInvalidTaskId)
+        {
+            LOG.error("Task not found: %s", outputId.c_str());
+            return nullptr;
+        }
+        return execute(id);
+    }
+
+    std::shared_ptr<DataObject> PipelineBuilder::execute(TaskNode::TaskId outputId)
     {
         // 只有在启用性能分析时才测量时间
         std::chrono::time_point<std::chrono::high_resolution_clock> start;
@@ -65,19 +86,70 @@ namespace GryFlux
             // 仅打印当前执行的任务时间，不打印全局统计
             LOG.debug("Current execution - task times:");
             auto taskTimes = scheduler_->getTaskExecutionTimes();
-            for (const auto &taskTime : taskTimes)
+            for (size_t id = 0; id < taskTimes.size(); ++id)
             {
-                LOG.debug("  - Task [%s]: %.3f ms", taskTime.first.c_str(), taskTime.second);
+                if (taskTimes[id] >= 0)
+                {
+                    LOG.debug("  - Task [%s]: %.3f ms", scheduler_->getTask(id)->getName().c_str(), taskTimes[id]);
+                }
             }
         }
 
         return result;
     }
 
+    void PipelineBuilder::instantiate(const GraphTemplate &graph)
+    {
+        if (!graph.isCompiled())
+        {
+            throw std::runtime_error("Graph template must be compiled before instantiation");
+        }
+
+        reset();
+        const auto &specs = graph.getNodes();
+        std::vector<std::shared_ptr<TaskNode>> nodes;
+        nodes.reserve(specs.size());
+        for (const auto &spec : specs)
+        {
+            if (!spec.func)
+            {
+                templateInput_ = std::make_shared<InputNode>(spec.id, nullptr);
+                scheduler_->addTask(templateInput_);
+                nodes.push_back(templateInput_);
+                continue;
+            }
+
+            std::vector<std::shared_ptr<TaskNode>> inputs;
+            for (size_t input : spec.inputs)
+            {
+                inputs.push_back(nodes[input]);
+            }
+            nodes.push_back(addTask(spec.id, spec.func, inputs, spec.conditions));
+            nodes.back()->setKind(spec.kind);
+        }
+
+        scheduler_->compile(graph.getOutputId());
+    }
+
+    void PipelineBuilder::bindInput(std::shared_ptr<DataObject> data)
+    {
+        if (!templateInput_)
+        {
+            throw std::runtime_error("Pipeline builder was not instantiated from a graph template");
+        }
+        scheduler_->resetTasks();
+        templateInput_->bind(data);
+    }
+
     void PipelineBuilder::reset()
     {
-        // 创建新的调度器，丢弃旧的任务图
-        scheduler_ = std::make_shared<TaskScheduler>();
+        // 创建新的调度器，丢弃旧的任务图，但继续使用原有线程池、I/O执行器与各节点的执行时间估计
+        auto ioExecutor = scheduler_->getIoExecutor();
+        auto timeEstimates = scheduler_->getTimeEstimates();
+        scheduler_ = std::make_shared<TaskScheduler>(scheduler_->getThreadPool());
+        scheduler_->setIoExecutor(std::move(ioExecutor));
+        scheduler_->setTimeEstimates(std::move(timeEstimates));
+        templateInput_.reset();
     }
 
 } // namespace GryFlux
\ No newline at end of file
@@ -0,0 +1,151 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#include "framework/processing_task.h"
+#include "utils/logger.h"
+#include <future>
+
+namespace GryFlux
+{
+
+    TaskInstancePool::TaskInstancePool(std::vector<std::shared_ptr<ProcessingTask>> instances,
+                                       TaskConcurrency concurrency)
+        : instances_(std::move(instances)), concurrency_(concurrency)
+    {
+        for (size_t i = instances_.size(); i > 0; --i)
+        {
+            freeInstances_.push_back(i - 1);
+        }
+    }
+
+    std::shared_ptr<DataObject> TaskInstancePool::process(const Inputs &inputs)
+    {
+        if (concurrency_.mode == TaskConcurrency::Mode::Unlimited)
+        {
+            return instances_.front()->process(inputs);
+        }
+
+        // 与挂起的调用一起排队，等到实例转交过来
+        std::promise<size_t> granted;
+        size_t index;
+        if (!acquire(index, [&granted](size_t grantedIndex)
+                     { granted.set_value(grantedIndex); }))
+        {
+            index = granted.get_future().get();
+        }
+        return run(index, inputs);
+    }
+
+    bool TaskInstancePool::invoke(const Inputs &inputs, std::shared_ptr<DataObject> &result,
+                                  Executor &executor, uint64_t priority, Completion done)
+    {
+        if (concurrency_.mode == TaskConcurrency::Mode::Unlimited)
+        {
+            result = instances_.front()->process(inputs);
+            return true;
+        }
+
+        // 挂起的调用整体放在堆上，提交到执行器的任务只捕获指针，不超出InplaceTask的容量
+        struct PendingCall
+        {
+            Inputs inputs;
+            Completion done;
+            uint64_t exclusiveInputs; // 恢复执行时重新设置，takeInput仍可原地修改移交的输入
+        };
+        auto call = std::make_shared<PendingCall>(PendingCall{inputs, std::move(done), ExclusiveInputs::current()});
+        auto self = shared_from_this();
+        Executor *target = &executor;
+        size_t index;
+        bool acquired = acquire(index, [self, call, target, priority](size_t grantedIndex)
+                                {
+            auto resume = [self, call, grantedIndex]()
+            {
+                std::shared_ptr<DataObject> result;
+                std::exception_ptr error;
+                try
+                {
+                    ExclusiveInputs::Scope exclusive(call->exclusiveInputs);
+                    result = self->run(grantedIndex, call->inputs);
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+                call->done(std::move(result), error);
+            };
+            try
+            {
+                // 在挂起调用所属的执行器上继续，归还实例的线程不替它执行
+                target->dispatch(resume, priority);
+            }
+            catch (const std::exception &e)
+            {
+                LOG.warning("Failed to resume suspended task call, running inline: %s", e.what());
+                resume();
+            } });
+        if (!acquired)
+        {
+            return false;
+        }
+
+        result = run(index, inputs);
+        return true;
+    }
+
+    bool TaskInstancePool::acquire(size_t &index, Grant grant)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // 已有调用在排队时不插队，实例按挂起的先后顺序转交
+        if (freeInstances_.empty() || !waiting_.empty())
+        {
+            waiting_.push_back(std::move(grant));
+            return false;
+        }
+        index = freeInstances_.back();
+        freeInstances_.pop_back();
+        return true;
+    }
+
+    void TaskInstancePool::release(size_t index)
+    {
+        Grant next;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (waiting_.empty())
+            {
+                freeInstances_.push_back(index);
+                return;
+            }
+            next = std::move(waiting_.front());
+            waiting_.pop_front();
+        }
+        next(index);
+    }
+
+    std::shared_ptr<DataObject> TaskInstancePool::run(size_t index, const Inputs &inputs)
+    {
+        // 无论process是否抛出异常都归还实例
+        struct Lease
+        {
+            TaskInstancePool &pool;
+            size_t index;
+            ~Lease() { pool.release(index); }
+        } lease{*this, index};
+
+        return instances_[index]->process(inputs);
+    }
+
+} // namespace GryFlux
@@ -0,0 +1,188 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#include "framework/reorder_buffer.h"
+#include "utils/logger.h"
+#include <algorithm>
+
+namespace GryFlux
+{
+
+    ReorderBuffer::ReorderBuffer(size_t window, std::chrono::milliseconds timeout, LateFramePolicy policy,
+                                 ReleaseCallback release)
+        : slots_(std::max<size_t>(window, 1)), timeout_(timeout), policy_(policy),
+          release_(std::move(release)), waiting_(false) {}
+
+    void ReorderBuffer::submit(uint64_t sequence, std::shared_ptr<DataObject> result, FramePlaceholder::Reason reason)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (sequence < nextSequence_)
+        {
+            // 该帧已被跳过，结果不再输出
+            stats_.lateArrivals++;
+            LOG.debug("[ReorderBuffer] Dropped late result for frame %llu",
+                      static_cast<unsigned long long>(sequence));
+            return;
+        }
+
+        // 超出窗口时按策略跳过队首帧，直到该结果能放入缓冲区
+        while (sequence >= nextSequence_ + slots_.size())
+        {
+            skipHead();
+            releaseReady();
+        }
+
+        auto &slot = slots_[sequence % slots_.size()];
+        slot.ready = true;
+        slot.result = std::move(result);
+        slot.reason = reason;
+        buffered_++;
+        stats_.maxBuffered = std::max(stats_.maxBuffered, buffered_);
+
+        releaseReady();
+        updateWaiting();
+        // 持续有结果提交时处理线程不会空闲调用poll，在这里同样检查超时
+        skipExpiredHead();
+    }
+
+    void ReorderBuffer::poll()
+    {
+        if (!waiting_.load(std::memory_order_acquire) || timeout_.count() <= 0)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        skipExpiredHead();
+    }
+
+    void ReorderBuffer::skipExpiredHead()
+    {
+        if (timeout_.count() <= 0 || buffered_ == 0 ||
+            std::chrono::high_resolution_clock::now() - headWaitStart_ < timeout_)
+        {
+            return;
+        }
+
+        skipHead();
+        releaseReady();
+        updateWaiting();
+    }
+
+    void ReorderBuffer::flush(uint64_t endSequence)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        while (nextSequence_ < endSequence)
+        {
+            releaseReady();
+            if (nextSequence_ < endSequence)
+            {
+                skipHead();
+            }
+        }
+        updateWaiting();
+    }
+
+    ReorderBuffer::Stats ReorderBuffer::getStats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+    void ReorderBuffer::releaseReady()
+    {
+        while (true)
+        {
+            auto &slot = slots_[nextSequence_ % slots_.size()];
+            if (!slot.ready)
+            {
+                return;
+            }
+
+            auto result = std::move(slot.result);
+            slot.ready = false;
+            slot.result.reset();
+            buffered_--;
+
+            if (result)
+            {
+                stats_.released++;
+            }
+            else if (slot.reason == FramePlaceholder::Reason::Dropped)
+            {
+                stats_.dropped++;
+            }
+            else if (slot.reason == FramePlaceholder::Reason::Pruned)
+            {
+                stats_.pruned++;
+            }
+            else
+            {
+                stats_.failed++;
+            }
+            emit(nextSequence_, std::move(result), slot.reason);
+            nextSequence_++;
+        }
+    }
+
+    void ReorderBuffer::skipHead()
+    {
+        auto &slot = slots_[nextSequence_ % slots_.size()];
+        if (slot.ready)
+        {
+            // 队首帧已就绪，正常释放即可
+            releaseReady();
+            return;
+        }
+
+        stats_.skipped++;
+        LOG.warning("[ReorderBuffer] Frame %llu is late, skipped", static_cast<unsigned long long>(nextSequence_));
+        emit(nextSequence_, nullptr, FramePlaceholder::Reason::Late);
+        nextSequence_++;
+    }
+
+    void ReorderBuffer::emit(uint64_t sequence, std::shared_ptr<DataObject> result, FramePlaceholder::Reason reason)
+    {
+        if (!result)
+        {
+            if (policy_ != LateFramePolicy::Placeholder)
+            {
+                return;
+            }
+            result = std::make_shared<FramePlaceholder>(reason);
+            result->setSequence(sequence);
+            stats_.placeholders++;
+        }
+
+        if (release_)
+        {
+            release_(std::move(result));
+        }
+    }
+
+    void ReorderBuffer::updateWaiting()
+    {
+        bool waiting = buffered_ > 0;
+        // 队首帧变化或刚开始等待时重新计时，每帧的等待时间单独计算
+        if (waiting && (!waiting_.load(std::memory_order_relaxed) || headSequence_ != nextSequence_))
+        {
+            headWaitStart_ = std::chrono::high_resolution_clock::now();
+            headSequence_ = nextSequence_;
+        }
+        waiting_.store(waiting, std::memory_order_release);
+    }
+
+} // namespace GryFlux
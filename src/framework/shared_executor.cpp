@@ -0,0 +1,175 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#include "framework/shared_executor.h"
+#include "utils/logger.h"
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+
+namespace GryFlux
+{
+
+    // 份额：任务先进入本地队列，每个已占用的配额在线程池中对应一个令牌任务，
+    // 令牌执行时取出本地优先级最高的任务运行，运行后若仍有任务且未超出配额则重新排到线程池共享队列的队尾。
+    // 令牌本身不带优先级：任务优先级（截止时间、关键路径）只在份额内比较，
+    // 否则进度落后的管道总是带着更早的截止时间插队，权重就失去了作用
+    class SharedExecutor::Share : public Executor
+    {
+    public:
+        Share(std::shared_ptr<SharedExecutor> owner, size_t weight, size_t maxTasks)
+            : owner_(std::move(owner)), weight_(weight), maxTasks_(maxTasks), inflight_(0) {}
+
+        // 令牌只持有份额的裸指针，析构时等待令牌全部归还，
+        // 这样份额与线程池总是在外部线程中释放，不会出现工作线程析构自身所在的线程池
+        ~Share() override
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            idle_.wait(lock, [this]
+                       { return inflight_ == 0; });
+        }
+
+        size_t getThreadCount() const override { return owner_->getThreadCount(); }
+
+        size_t getTaskCount() const override
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return pending_.size();
+        }
+
+        bool isThreadPolicyGranted() const override { return owner_->isThreadPolicyGranted(); }
+
+    protected:
+        void post(InplaceTask task, uint64_t priority) override
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (pending_.empty() && inflight_ == 0)
+                {
+                    owner_->activeWeight_.fetch_add(weight_, std::memory_order_relaxed);
+                }
+                pending_.push(std::move(task), priority);
+                if (inflight_ >= quota())
+                {
+                    return;
+                }
+                ++inflight_;
+            }
+            issueToken();
+        }
+
+    private:
+        size_t quota() const
+        {
+            size_t quota = owner_->quotaFor(weight_);
+            return maxTasks_ > 0 ? std::min(quota, maxTasks_) : quota;
+        }
+
+        void issueToken()
+        {
+            owner_->pool_->dispatch([this]()
+                                    { runOne(); });
+        }
+
+        // 释放一个配额，份额没有任务时退出活跃权重；调用时需持有锁
+        void releaseLocked()
+        {
+            if (--inflight_ == 0)
+            {
+                if (pending_.empty())
+                {
+                    owner_->activeWeight_.fetch_sub(weight_, std::memory_order_relaxed);
+                }
+                idle_.notify_all();
+            }
+        }
+
+        void runOne()
+        {
+            InplaceTask task;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (pending_.empty())
+                {
+                    releaseLocked();
+                    return;
+                }
+                pending_.pop_front(task);
+            }
+
+            try
+            {
+                task();
+            }
+            catch (const std::exception &e)
+            {
+                LOG.error("Exception in shared executor task: %s", e.what());
+            }
+            catch (...)
+            {
+                LOG.error("Unknown exception in shared executor task");
+            }
+            task.reset();
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (pending_.empty() || inflight_ > quota())
+                {
+                    releaseLocked();
+                    return;
+                }
+            }
+            issueToken();
+        }
+
+        std::shared_ptr<SharedExecutor> owner_;
+        const size_t weight_;
+        const size_t maxTasks_;
+        mutable std::mutex mutex_;
+        std::condition_variable idle_;
+        TaskQueue pending_;
+        size_t inflight_; // 已占用的配额，即线程池中属于本份额的令牌数
+    };
+
+    SharedExecutor::SharedExecutor(std::shared_ptr<Executor> pool)
+        : pool_(std::move(pool)), activeWeight_(0) {}
+
+    std::shared_ptr<SharedExecutor> SharedExecutor::create(size_t numThreads, const CpuAffinity &affinity,
+                                                           const ThreadPolicy &policy)
+    {
+        return std::shared_ptr<SharedExecutor>(
+            new SharedExecutor(createThreadPool(numThreads, ThreadPoolType::SharedQueue, affinity, policy)));
+    }
+
+    std::shared_ptr<SharedExecutor> SharedExecutor::getInstance()
+    {
+        static std::shared_ptr<SharedExecutor> instance = create();
+        return instance;
+    }
+
+    std::shared_ptr<Executor> SharedExecutor::attach(size_t weight, size_t maxTasks)
+    {
+        return std::make_shared<Share>(shared_from_this(), std::max<size_t>(weight, 1), maxTasks);
+    }
+
+    size_t SharedExecutor::quotaFor(size_t weight) const
+    {
+        size_t total = std::max(activeWeight_.load(std::memory_order_relaxed), weight);
+        size_t threads = pool_->getThreadCount();
+        return std::max<size_t>((threads * weight + total - 1) / total, 1);
+    }
+
+} // namespace GryFlux
@@ -0,0 +1,506 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#include "framework/stage_graph.h"
+#include "framework/exclusive_inputs.h"
+#include "utils/logger.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace GryFlux
+{
+
+    // 在各阶段之间流动的帧：保存每个节点的结果及其尚未完成的输入数量
+    struct StageGraph::Frame
+    {
+        std::vector<std::shared_ptr<DataObject>> results;
+        std::unique_ptr<std::atomic<size_t>[]> pendingInputs;
+        std::unique_ptr<std::atomic<size_t>[]> pendingConsumers; // 尚未处理完的后继数量，归零时释放结果
+        // 结果就是某个未独占的输入对象（阶段原样返回了输入），不能移交给后继；由产生结果的阶段在complete之前写入
+        std::vector<char> sharedResults;
+        std::atomic<bool> failed{false};
+        std::atomic<bool> dropped{false};
+        uint64_t sequence = 0;
+        DataObject::Clock::time_point deadline = DataObject::Clock::time_point::max();
+        std::chrono::time_point<std::chrono::high_resolution_clock> startTime;
+    };
+
+    // 阶段：有界输入队列 + 固定数量的工作线程
+    struct StageGraph::Stage
+    {
+        std::string name;
+        GraphTemplate::ProcessFunction func;
+        StageConfig config;
+
+        // 队列中的帧，按截止时间排成最小堆，截止时间相同时按入队顺序
+        struct Entry
+        {
+            DataObject::Clock::time_point deadline;
+            uint64_t order;
+            std::shared_ptr<Frame> frame;
+        };
+
+        // 堆顶为截止时间最早、入队最早的帧
+        struct Later
+        {
+            bool operator()(const Entry &a, const Entry &b) const
+            {
+                return a.deadline != b.deadline ? a.deadline > b.deadline : a.order > b.order;
+            }
+        };
+
+        std::mutex mutex;
+        std::condition_variable notEmpty;
+        std::condition_variable notFull;
+        std::vector<Entry> queue; // 容量在构造时按queueCapacity预留，入队出队不分配内存
+        uint64_t order = 0;
+        size_t maxDepth = 0;
+        bool closed = false;
+
+        std::vector<std::thread> workers;
+
+        std::atomic<size_t> processed{0};
+        std::atomic<uint64_t> busyNs{0};
+        std::atomic<uint64_t> blockedNs{0};
+        std::atomic<size_t> dropped{0};
+        std::atomic<size_t> pruned{0};
+        std::atomic<size_t> policyDenied{0}; // 未获得请求调度策略的工作线程数
+
+        // 预计本阶段处理一帧的耗时（平均值），用于判断帧能否按时完成
+        DataObject::Clock::duration expectedDuration() const
+        {
+            size_t count = processed.load(std::memory_order_relaxed);
+            if (count == 0)
+            {
+                return DataObject::Clock::duration::zero();
+            }
+            return std::chrono::duration_cast<DataObject::Clock::duration>(
+                std::chrono::nanoseconds(busyNs.load(std::memory_order_relaxed) / count));
+        }
+
+        // 队列满时阻塞，阻塞时间计入本阶段，用于定位瓶颈
+        void push(std::shared_ptr<Frame> frame)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (queue.size() >= config.queueCapacity)
+            {
+                auto start = std::chrono::high_resolution_clock::now();
+                notFull.wait(lock, [this]
+                             { return queue.size() < config.queueCapacity; });
+                auto blocked = std::chrono::high_resolution_clock::now() - start;
+                blockedNs.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(blocked).count(),
+                                    std::memory_order_relaxed);
+            }
+            auto deadline = frame->deadline;
+            queue.push_back({deadline, order++, std::move(frame)});
+            std::push_heap(queue.begin(), queue.end(), Later());
+            maxDepth = std::max(maxDepth, queue.size());
+            lock.unlock();
+            notEmpty.notify_one();
+        }
+
+        // 取出截止时间最早的帧（截止时间相同则先进先出），队列关闭且为空时返回false
+        bool pop(std::shared_ptr<Frame> &frame)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            notEmpty.wait(lock, [this]
+                          { return closed || !queue.empty(); });
+            if (queue.empty())
+            {
+                return false;
+            }
+            std::pop_heap(queue.begin(), queue.end(), Later());
+            frame = std::move(queue.back().frame);
+            queue.pop_back();
+            lock.unlock();
+            notFull.notify_one();
+            return true;
+        }
+
+        void close()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                closed = true;
+            }
+            notEmpty.notify_all();
+        }
+    };
+
+    StageGraph::StageGraph(const GraphTemplate &graph,
+                           const std::unordered_map<std::string, StageConfig> &configs,
+                           OutputCallback onOutput)
+        : nodes_(graph.getNodes()), onOutput_(std::move(onOutput)), completedFrames_(0), totalLatencyNs_(0)
+    {
+        if (!graph.isCompiled())
+        {
+            throw std::runtime_error("Graph template must be compiled before use");
+        }
+
+        successors_.resize(nodes_.size());
+        stages_.resize(nodes_.size());
+        remainingPath_.reset(new std::atomic<DataObject::Clock::rep>[nodes_.size()]);
+        for (size_t i = 0; i < nodes_.size(); ++i)
+        {
+            remainingPath_[i].store(0, std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < nodes_.size(); ++i)
+        {
+            const auto &node = nodes_[i];
+            if (node.id == graph.getInputId())
+            {
+                inputIndex_ = i;
+            }
+            if (node.id == graph.getOutputId())
+            {
+                outputIndex_ = i;
+            }
+            for (size_t input : node.inputs)
+            {
+                successors_[input].push_back(i);
+            }
+            if (!node.func)
+            {
+                continue;
+            }
+
+            auto stage = std::make_unique<Stage>();
+            stage->name = node.id;
+            stage->func = node.func;
+            auto it = configs.find(node.id);
+            if (it != configs.end())
+            {
+                stage->config = it->second;
+            }
+            stage->config.workers = std::max<size_t>(stage->config.workers, 1);
+            stage->config.queueCapacity = std::max<size_t>(stage->config.queueCapacity, 1);
+            stage->queue.reserve(stage->config.queueCapacity);
+            stages_[i] = std::move(stage);
+        }
+
+        for (const auto &config : configs)
+        {
+            if (std::none_of(nodes_.begin(), nodes_.end(), [&config](const GraphTemplate::NodeSpec &node)
+                             { return node.func && node.id == config.first; }))
+            {
+                LOG.warning("[StageGraph] Stage config for unknown node [%s] ignored", config.first.c_str());
+            }
+        }
+    }
+
+    StageGraph::~StageGraph()
+    {
+        stop();
+    }
+
+    void StageGraph::start()
+    {
+        if (running_)
+        {
+            return;
+        }
+        running_ = true;
+
+        for (size_t i = 0; i < stages_.size(); ++i)
+        {
+            if (!stages_[i])
+            {
+                continue;
+            }
+            auto &stage = *stages_[i];
+            stage.closed = false;
+            for (size_t w = 0; w < stage.config.workers; ++w)
+            {
+                stage.workers.emplace_back(&StageGraph::workerLoop, this, i);
+            }
+            LOG.debug("[StageGraph] Stage [%s] started with %zu worker(s), queue capacity %zu",
+                      stage.name.c_str(), stage.config.workers, stage.config.queueCapacity);
+        }
+    }
+
+    void StageGraph::stop()
+    {
+        if (!running_)
+        {
+            return;
+        }
+
+        // 节点按拓扑序排列：关闭某个阶段时其所有上游阶段都已退出，不会再有帧进入
+        for (auto &stage : stages_)
+        {
+            if (!stage)
+            {
+                continue;
+            }
+            stage->close();
+            for (auto &worker : stage->workers)
+            {
+                if (worker.joinable())
+                {
+                    worker.join();
+                }
+            }
+            stage->workers.clear();
+        }
+        running_ = false;
+        LOG.debug("[StageGraph] Stopped, %zu frame(s) completed", completedFrames_.load());
+    }
+
+    void StageGraph::push(std::shared_ptr<DataObject> input)
+    {
+        if (!running_)
+        {
+            throw std::runtime_error("Cannot push to a stopped StageGraph");
+        }
+
+        auto frame = std::make_shared<Frame>();
+        frame->results.resize(nodes_.size());
+        frame->sharedResults.assign(nodes_.size(), 0);
+        frame->pendingInputs.reset(new std::atomic<size_t>[nodes_.size()]);
+        frame->pendingConsumers.reset(new std::atomic<size_t>[nodes_.size()]);
+        for (size_t i = 0; i < nodes_.size(); ++i)
+        {
+            frame->pendingInputs[i].store(nodes_[i].inputs.size(), std::memory_order_relaxed);
+            frame->pendingConsumers[i].store(successors_[i].size(), std::memory_order_relaxed);
+        }
+        frame->sequence = input ? input->getSequence() : 0;
+        frame->deadline = input ? input->getDeadline() : DataObject::Clock::time_point::max();
+        frame->startTime = std::chrono::high_resolution_clock::now();
+
+        complete(frame, inputIndex_, std::move(input));
+    }
+
+    void StageGraph::complete(const std::shared_ptr<Frame> &frame, size_t index, std::shared_ptr<DataObject> result)
+    {
+        frame->results[index] = std::move(result);
+
+        if (index == outputIndex_)
+        {
+            auto latency = std::chrono::high_resolution_clock::now() - frame->startTime;
+            totalLatencyNs_.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count(),
+                                      std::memory_order_relaxed);
+            completedFrames_.fetch_add(1, std::memory_order_relaxed);
+            if (onOutput_)
+            {
+                FrameStatus status = frame->dropped.load()  ? FrameStatus::Dropped
+                                     : frame->failed.load() ? FrameStatus::Failed
+                                                            : FrameStatus::Completed;
+                onOutput_(frame->sequence, frame->results[index], status);
+            }
+            return;
+        }
+
+        // 输入计数归零说明该后继的所有输入都已就绪，帧进入其阶段队列
+        for (size_t successor : successors_[index])
+        {
+            if (frame->pendingInputs[successor].fetch_sub(1, std::memory_order_acq_rel) != 1)
+            {
+                continue;
+            }
+
+            const auto &node = nodes_[successor];
+            EdgeConditionCheck check;
+            for (size_t i = 0; i < node.inputs.size(); ++i)
+            {
+                check.add(frame->results[node.inputs[i]], node.conditions[i]);
+            }
+            if (check.getPrunedResult())
+            {
+                stages_[successor]->pruned.fetch_add(1, std::memory_order_relaxed);
+                auto pruned = check.getPrunedResult();
+                releaseInputs(*frame, successor);
+                complete(frame, successor, std::move(pruned));
+            }
+            else
+            {
+                stages_[successor]->push(frame);
+            }
+        }
+    }
+
+    DataObject::Clock::duration StageGraph::remainingPath(size_t index) const
+    {
+        return DataObject::Clock::duration(remainingPath_[index].load(std::memory_order_relaxed));
+    }
+
+    void StageGraph::refreshRemainingPaths()
+    {
+        // 平均耗时变化缓慢，限制刷新频率；多个工作线程同时到期时只有一个刷新
+        auto now = DataObject::Clock::now().time_since_epoch().count();
+        auto due = nextPathRefresh_.load(std::memory_order_relaxed);
+        auto interval = std::chrono::duration_cast<DataObject::Clock::duration>(kPathRefreshInterval).count();
+        if (now < due || !nextPathRefresh_.compare_exchange_strong(due, now + interval, std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        // 节点按拓扑序排列，后继的序号总是更大，逆序计算即可
+        for (size_t i = nodes_.size(); i-- > 0;)
+        {
+            DataObject::Clock::rep path = 0;
+            for (size_t successor : successors_[i])
+            {
+                path = std::max(path, remainingPath_[successor].load(std::memory_order_relaxed));
+            }
+            if (stages_[i])
+            {
+                path += stages_[i]->expectedDuration().count();
+            }
+            remainingPath_[i].store(path, std::memory_order_relaxed);
+        }
+    }
+
+    void StageGraph::releaseInputs(Frame &frame, size_t index)
+    {
+        for (size_t input : nodes_[index].inputs)
+        {
+            if (frame.pendingConsumers[input].fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                frame.results[input].reset();
+            }
+        }
+    }
+
+    void StageGraph::workerLoop(size_t index)
+    {
+        auto &stage = *stages_[index];
+        stage.config.affinity.applyToCurrentThread();
+        if (!applyThreadPolicy(stage.config.policy, "Stage [" + stage.name + "]").granted())
+        {
+            stage.policyDenied.fetch_add(1, std::memory_order_relaxed);
+        }
+        const auto &inputs = nodes_[index].inputs;
+        const auto &conditions = nodes_[index].conditions;
+        std::vector<std::shared_ptr<DataObject>> inputResults;
+        inputResults.reserve(inputs.size());
+
+        std::shared_ptr<Frame> frame;
+        while (stage.pop(frame))
+        {
+            inputResults.clear();
+            uint64_t exclusive = 0;
+            for (size_t i = 0; i < inputs.size(); ++i)
+            {
+                size_t input = inputs[i];
+                // 本阶段是该结果唯一剩余的读取者时移交所有权，任务可以原地修改
+                if (frame->pendingConsumers[input].load(std::memory_order_acquire) == 1 && !frame->sharedResults[input])
+                {
+                    inputResults.push_back(std::move(frame->results[input]));
+                    if (inputResults.back())
+                    {
+                        exclusive |= ExclusiveInputs::bit(i);
+                    }
+                }
+                else
+                {
+                    inputResults.push_back(frame->results[input]);
+                }
+                // 与MultiInputTaskNode一致：接受错误的输入边上，失败的前驱以TaskOutcome::error()传入
+                if (!inputResults.back() && hasCondition(conditions[i], EdgeCondition::OnError))
+                {
+                    inputResults.back() = TaskOutcome::error();
+                }
+            }
+
+            // 本阶段到输出的剩余关键路径已超出截止时间的帧不再执行剩余阶段，
+            // 在上游就放弃，不会先占用后面的耗时阶段
+            if (!frame->dropped.load() && frame->deadline != DataObject::Clock::time_point::max() &&
+                DataObject::Clock::now() + remainingPath(index) > frame->deadline)
+            {
+                frame->dropped = true;
+                stage.dropped.fetch_add(1, std::memory_order_relaxed);
+                LOG.debug("[StageGraph] Frame %llu cannot meet its deadline, dropped before stage [%s]",
+                          static_cast<unsigned long long>(frame->sequence), stage.name.c_str());
+            }
+
+            // 与MultiInputTaskNode一致：任一输入为空时不调用处理函数，结果为空
+            std::shared_ptr<DataObject> result;
+            if (!frame->dropped.load() && std::none_of(inputResults.begin(), inputResults.end(),
+                             [](const std::shared_ptr<DataObject> &obj)
+                             { return !obj; }))
+            {
+                auto start = std::chrono::high_resolution_clock::now();
+                try
+                {
+                    ExclusiveInputs::Scope scope(exclusive);
+                    result = stage.func(inputResults);
+                }
+                catch (const std::exception &e)
+                {
+                    frame->failed = true;
+                    LOG.error("[StageGraph] Exception in stage [%s]: %s", stage.name.c_str(), e.what());
+                }
+                catch (...)
+                {
+                    frame->failed = true;
+                    LOG.error("[StageGraph] Unknown exception in stage [%s]", stage.name.c_str());
+                }
+                auto busy = std::chrono::high_resolution_clock::now() - start;
+                stage.busyNs.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(busy).count(),
+                                       std::memory_order_relaxed);
+                stage.processed.fetch_add(1, std::memory_order_relaxed);
+                refreshRemainingPaths();
+            }
+
+            for (size_t i = 0; result && i < inputResults.size(); ++i)
+            {
+                if (inputResults[i] == result && (exclusive & ExclusiveInputs::bit(i)) == 0)
+                {
+                    frame->sharedResults[index] = 1;
+                }
+            }
+
+            // 最后一个使用某输入的阶段处理完后释放该输入，帧只保留后续阶段仍需要的结果
+            inputResults.clear();
+            releaseInputs(*frame, index);
+
+            complete(frame, index, std::move(result));
+            frame.reset();
+        }
+    }
+
+    std::vector<StageGraph::StageStats> StageGraph::getStageStats() const
+    {
+        std::vector<StageStats> stats;
+        for (const auto &stage : stages_)
+        {
+            if (!stage)
+            {
+                continue;
+            }
+
+            StageStats stat;
+            stat.name = stage->name;
+            stat.workers = stage->config.workers;
+            stat.queueCapacity = stage->config.queueCapacity;
+            {
+                std::lock_guard<std::mutex> lock(stage->mutex);
+                stat.queueDepth = stage->queue.size();
+                stat.maxQueueDepth = stage->maxDepth;
+            }
+            stat.processed = stage->processed.load(std::memory_order_relaxed);
+            stat.totalTimeMs = stage->busyNs.load(std::memory_order_relaxed) / 1e6;
+            stat.blockedTimeMs = stage->blockedNs.load(std::memory_order_relaxed) / 1e6;
+            stat.dropped = stage->dropped.load(std::memory_order_relaxed);
+            stat.pruned = stage->pruned.load(std::memory_order_relaxed);
+            stat.policy = stage->config.policy;
+            stat.policyGranted = stage->policyDenied.load(std::memory_order_relaxed) == 0;
+            stats.push_back(std::move(stat));
+        }
+        return stats;
+    }
+
+} // namespace GryFlux
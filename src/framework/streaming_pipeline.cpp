@@ -21,22 +21,46 @@
 #include <algorithm>
 #include <iomanip>
 #include <sstream>
-#include <unordered_map>
 
 namespace GryFlux
 {
 
-    StreamingPipeline::StreamingPipeline(size_t numThreads, size_t queueSize)
-        : pipelineBuilder_(std::make_shared<PipelineBuilder>(numThreads > 0 ? numThreads : std::thread::hardware_concurrency())),
-          inputQueue_(std::make_shared<threadsafe_queue<std::shared_ptr<DataObject>>>()),
-          outputQueue_(std::make_shared<threadsafe_queue<std::shared_ptr<DataObject>>>()),
+    StreamingPipeline::StreamingPipeline(size_t numThreads, size_t queueSize, size_t maxFramesInFlight,
+                                         ThreadPoolType poolType, const CpuAffinity &affinity)
+        : StreamingPipeline(createThreadPool(numThreads, poolType, affinity),
+                            queueSize, maxFramesInFlight)
+    {
+        poolType_ = poolType;
+        poolAffinity_ = affinity;
+        externalExecutor_ = false;
+    }
+
+    StreamingPipeline::StreamingPipeline(std::shared_ptr<Executor> executor, size_t queueSize,
+                                         size_t maxFramesInFlight)
+        : threadPool_(std::move(executor)),
+          poolType_(ThreadPoolType::SharedQueue),
+          poolAffinity_(CpuAffinity::any()),
+          externalExecutor_(true),
+          inputQueue_(createQueue(QueueType::Locked, queueSize)),
+          outputQueue_(createQueue(QueueType::Locked, 0)),
           outputNodeId_("output"),
+          activeProcessingLoops_(0),
           running_(false),
           queueMaxSize_(queueSize),
+          maxFramesInFlight_(maxFramesInFlight > 0 ? maxFramesInFlight : 1),
+          nextSequence_(0),
           processedItems_(0),
           errorCount_(0),
+          droppedFrames_(0),
+          prunedFrames_(0),
           totalProcessingTime_(0),
-          profilingEnabled_(false) {}
+          profilingEnabled_(false)
+    {
+        if (!threadPool_)
+        {
+            throw std::runtime_error("Executor must not be null");
+        }
+    }
 
     StreamingPipeline::~StreamingPipeline()
     {
@@ -50,24 +74,107 @@ namespace GryFlux
             return;
         }
 
-        if (!processor_)
+        if (!processor_ && !graphTemplate_)
+        {
+            throw std::runtime_error("Processor function or graph template not set");
+        }
+        if (executionMode_ == ExecutionMode::StageParallel && !graphTemplate_)
+        {
+            throw std::runtime_error("Stage-parallel mode requires a graph template");
+        }
+        if (inputQueueType_ == QueueType::LockFreeSPSC &&
+            ((executionMode_ == ExecutionMode::TaskGraph && maxFramesInFlight_ > 1) ||
+             overflowPolicy_ == InputOverflowPolicy::DropOldest || overflowPolicy_ == InputOverflowPolicy::KeepLatest))
         {
-            throw std::runtime_error("Processor function not set");
+            throw std::runtime_error("SPSC input queue requires a single processing loop and an overflow policy "
+                                     "that does not evict from the producer side");
+        }
+        if (outputQueueType_ == QueueType::LockFreeSPSC && !orderedOutput_ &&
+            (executionMode_ != ExecutionMode::TaskGraph || maxFramesInFlight_ > 1))
+        {
+            throw std::runtime_error("SPSC output queue requires ordered output or a single frame in flight");
         }
 
         // 重置统计数据
         processedItems_ = 0;
         errorCount_ = 0;
+        droppedFrames_ = 0;
+        prunedFrames_ = 0;
+        inputAccepted_ = 0;
+        inputBlocked_ = 0;
+        inputDroppedNewest_ = 0;
+        inputDroppedOldest_ = 0;
+        inputReplaced_ = 0;
         totalProcessingTime_ = 0;
-        taskStats_.clear(); // 重置任务统计数据
+        slotStats_.assign(maxFramesInFlight_, SlotStats()); // 重置任务统计数据
+        stageGraph_.reset();
+        nextSequence_ = 0;
+        reorderBuffer_.reset();
+        if (orderedOutput_)
+        {
+            reorderBuffer_ = std::make_unique<ReorderBuffer>(reorderWindow_, lateFrameTimeout_, lateFramePolicy_,
+                                                             [this](std::shared_ptr<DataObject> result)
+                                                             { outputQueue_->push(result); });
+        }
         startTime_ = std::chrono::high_resolution_clock::now();
 
+        inputQueue_->reopen();
+        outputQueue_->reopen();
         running_ = true;
         input_active_ = true;
         output_active_ = true;
-        processingThread_ = std::thread(&StreamingPipeline::processingLoop, this);
+        LOG.debug("[Pipeline] CPU topology: %s", CpuTopology::getInstance().describe().c_str());
+
+        // 批处理任务据此判断批次何时凑满：最多有在途帧数（阶段并行模式下为该阶段的工作线程数）个调用同时等待
+        if (graphTemplate_)
+        {
+            for (const auto &node : graphTemplate_->getNodes())
+            {
+                size_t callers = maxFramesInFlight_;
+                if (executionMode_ == ExecutionMode::StageParallel)
+                {
+                    auto it = stageConfigs_.find(node.id);
+                    callers = it != stageConfigs_.end() ? it->second.workers : StageGraph::StageConfig().workers;
+                    callers = std::max<size_t>(callers, 1);
+                }
+                registerCallers(callerRegistrations_, SuspendableTask::from(node.func), callers);
+            }
+        }
+
+        if (executionMode_ == ExecutionMode::StageParallel)
+        {
+            // 输出阶段的工作线程直接把结果放入输出队列
+            stageGraph_ = std::make_unique<StageGraph>(*graphTemplate_, stageConfigs_,
+                                                       [this](uint64_t sequence, std::shared_ptr<DataObject> result,
+                                                              StageGraph::FrameStatus status)
+                                                       {
+                                                           if (status == StageGraph::FrameStatus::Failed)
+                                                           {
+                                                               errorCount_++;
+                                                           }
+                                                           else if (status == StageGraph::FrameStatus::Dropped)
+                                                           {
+                                                               droppedFrames_++;
+                                                               deliverResult(sequence, nullptr, FramePlaceholder::Reason::Dropped);
+                                                               return;
+                                                           }
+                                                           deliverResult(sequence, result);
+                                                       });
+            stageGraph_->start();
+            activeProcessingLoops_ = 1;
+            processingThreads_.emplace_back(&StreamingPipeline::stageFeedLoop, this);
+
+            LOG.debug("[Pipeline] Started streaming pipeline in stage-parallel mode");
+            return;
+        }
 
-        LOG.debug("[Pipeline] Started streaming pipeline");
+        activeProcessingLoops_ = maxFramesInFlight_;
+        for (size_t slot = 0; slot < maxFramesInFlight_; ++slot)
+        {
+            processingThreads_.emplace_back(&StreamingPipeline::processingLoop, this, slot);
+        }
+
+        LOG.debug("[Pipeline] Started streaming pipeline with %zu frame(s) in flight", maxFramesInFlight_);
     }
 
     void StreamingPipeline::stop()
@@ -79,27 +186,81 @@ namespace GryFlux
 
         running_ = false;
         input_active_ = false;
+        // 唤醒阻塞的生产者与空闲的处理线程，处理线程取完剩余输入后退出
+        inputQueue_->close();
+        {
+            std::lock_guard<std::mutex> lock(inputMutex_);
+            inputNotFull_.notify_all();
+        }
 
-        if (processingThread_.joinable())
+        for (auto &thread : processingThreads_)
         {
-            processingThread_.join();
+            if (thread.joinable())
+            {
+                thread.join();
+            }
         }
+        processingThreads_.clear();
+        unregisterCallers(callerRegistrations_);
 
         output_active_ = false;
 
-        // 清理PipelineBuilder对象
-        pipelineBuilder_.reset();
-
         // 只有在启用性能分析时才输出统计数据
         if (profilingEnabled_)
         {
+            // 按名称合并各槽位的统计数据，仅在停止时进行一次
+            std::vector<TaskStat> taskStats;
+            for (const auto &slotStats : slotStats_)
+            {
+                totalProcessingTime_ += slotStats.totalProcessingTime;
+                for (const auto &stat : slotStats.tasks)
+                {
+                    if (stat.count == 0)
+                    {
+                        continue;
+                    }
+                    auto it = std::find_if(taskStats.begin(), taskStats.end(),
+                                           [&stat](const TaskStat &merged)
+                                           { return merged.name == stat.name; });
+                    if (it == taskStats.end())
+                    {
+                        taskStats.push_back(stat);
+                    }
+                    else
+                    {
+                        it->totalTimeMs += stat.totalTimeMs;
+                        it->count += stat.count;
+                    }
+                }
+            }
+
+            // 阶段并行模式下按帧从进入第一个阶段到离开输出阶段统计处理时间
+            if (stageGraph_)
+            {
+                totalProcessingTime_ += stageGraph_->getTotalLatencyMs();
+            }
+
             auto endTime = std::chrono::high_resolution_clock::now();
             auto totalTime = std::chrono::duration<double, std::milli>(endTime - startTime_).count();
 
             LOG.info("[Pipeline] Statistics:");
             LOG.info("  - Total items processed: %zu", processedItems_);
             LOG.info("  - Error count: %zu", errorCount_);
+            LOG.info("  - Dropped frames (deadline): %zu", droppedFrames_.load());
+            LOG.info("  - Pruned frames (edge conditions): %zu", prunedFrames_.load());
+            LOG.info("  - Input queue: %zu accepted, %zu blocked, %zu dropped newest, %zu dropped oldest, %zu replaced",
+                     inputAccepted_.load(), inputBlocked_.load(), inputDroppedNewest_.load(),
+                     inputDroppedOldest_.load(), inputReplaced_.load());
             LOG.info("  - Total running time: %.3f ms", totalTime);
+            if (!poolPolicy_.isDefault())
+            {
+                LOG.info("  - Worker thread policy %s: %s", poolPolicy_.describe().c_str(),
+                         threadPool_->isThreadPolicyGranted() ? "granted" : "NOT granted");
+            }
+            if (ioExecutor_)
+            {
+                LOG.info("  - I/O executor: %zu threads", ioExecutor_->getThreadCount());
+            }
 
             if (processedItems_ > 0)
             {
@@ -109,20 +270,32 @@ namespace GryFlux
             }
 
             // 输出同名任务的全局平均执行时间
-            if (!taskStats_.empty())
+            if (!taskStats.empty())
             {
                 LOG.info("[Pipeline] Global average execution time for tasks with the same name:");
-                for (const auto &taskStat : taskStats_)
+                for (const auto &taskStat : taskStats)
                 {
-                    const std::string &taskName = taskStat.first;
-                    double totalTime = taskStat.second.first;
-                    size_t count = taskStat.second.second;
-                    double avgTime = totalTime / count;
+                    double avgTime = taskStat.totalTimeMs / taskStat.count;
 
                     LOG.info("  - Task [%s]: %.3f ms (average of %zu executions across all items)",
-                             taskName.c_str(), avgTime, count);
+                             taskStat.name.c_str(), avgTime, taskStat.count);
                 }
             }
+
+            if (stageGraph_)
+            {
+                logStageStats(totalTime);
+            }
+
+            if (reorderBuffer_)
+            {
+                auto reorderStats = reorderBuffer_->getStats();
+                LOG.info("[Pipeline] Ordered output: %zu released, %zu failed, %zu dropped, %zu pruned, %zu skipped as late, "
+                         "%zu late arrivals dropped, %zu placeholders, max %zu waiting",
+                         reorderStats.released, reorderStats.failed, reorderStats.dropped, reorderStats.pruned,
+                         reorderStats.skipped,
+                         reorderStats.lateArrivals, reorderStats.placeholders, reorderStats.maxBuffered);
+            }
         }
         else
         {
@@ -137,6 +310,116 @@ namespace GryFlux
             throw std::runtime_error("Cannot set processor while pipeline is running");
         }
         processor_ = processor;
+        graphTemplate_.reset();
+        timeEstimates_ = std::make_shared<TaskTimeEstimates>();
+    }
+
+    void StreamingPipeline::setGraphTemplate(std::shared_ptr<GraphTemplate> graph)
+    {
+        if (running_)
+        {
+            throw std::runtime_error("Cannot set graph template while pipeline is running");
+        }
+        if (!graph || !graph->isCompiled())
+        {
+            throw std::runtime_error("Graph template must be compiled before use");
+        }
+        graphTemplate_ = graph;
+        outputNodeId_ = graph->getOutputId();
+        processor_ = nullptr;
+        timeEstimates_ = std::make_shared<TaskTimeEstimates>();
+    }
+
+    void StreamingPipeline::setExecutionMode(ExecutionMode mode)
+    {
+        if (running_)
+        {
+            throw std::runtime_error("Cannot set execution mode while pipeline is running");
+        }
+        executionMode_ = mode;
+    }
+
+    void StreamingPipeline::setStageConfig(const std::string &nodeId, size_t workers, size_t queueCapacity,
+                                           const CpuAffinity &affinity)
+    {
+        StageGraph::StageConfig config;
+        config.workers = workers;
+        config.queueCapacity = queueCapacity;
+        config.affinity = affinity;
+        setStageConfig(nodeId, config);
+    }
+
+    void StreamingPipeline::setStageConfig(const std::string &nodeId, const StageGraph::StageConfig &config)
+    {
+        if (running_)
+        {
+            throw std::runtime_error("Cannot set stage config while pipeline is running");
+        }
+        auto &stored = stageConfigs_[nodeId] = config;
+        stored.workers = std::max<size_t>(stored.workers, 1);
+        stored.queueCapacity = std::max<size_t>(stored.queueCapacity, 1);
+    }
+
+    void StreamingPipeline::setThreadPolicy(const ThreadPolicy &policy)
+    {
+        if (running_)
+        {
+            throw std::runtime_error("Cannot set thread policy while pipeline is running");
+        }
+        if (externalExecutor_)
+        {
+            throw std::runtime_error("Thread policy of an external executor must be set when it is created");
+        }
+        // 工作线程只在启动时应用调度策略，因此按原有配置重建线程池
+        threadPool_ = createThreadPool(threadPool_->getThreadCount(), poolType_, poolAffinity_, policy);
+        poolPolicy_ = policy;
+    }
+
+    void StreamingPipeline::setIoExecutor(std::shared_ptr<Executor> ioExecutor)
+    {
+        if (running_)
+        {
+            throw std::runtime_error("Cannot set I/O executor while pipeline is running");
+        }
+        ioExecutor_ = std::move(ioExecutor);
+    }
+
+    void StreamingPipeline::setOrderedOutput(bool enable, size_t window)
+    {
+        if (running_)
+        {
+            throw std::runtime_error("Cannot change output ordering while pipeline is running");
+        }
+        orderedOutput_ = enable;
+        reorderWindow_ = window > 0 ? window : 1;
+    }
+
+    void StreamingPipeline::setLateFramePolicy(LateFramePolicy policy, std::chrono::milliseconds timeout)
+    {
+        if (running_)
+        {
+            throw std::runtime_error("Cannot set late frame policy while pipeline is running");
+        }
+        lateFramePolicy_ = policy;
+        lateFrameTimeout_ = timeout;
+    }
+
+    void StreamingPipeline::setFrameDeadline(std::chrono::milliseconds budget)
+    {
+        if (running_)
+        {
+            throw std::runtime_error("Cannot set frame deadline while pipeline is running");
+        }
+        frameBudget_ = budget;
+    }
+
+    std::vector<StageGraph::StageStats> StreamingPipeline::getStageStats() const
+    {
+        if (!stageGraph_)
+        {
+            return {};
+        }
+        return stageGraph_->getStageStats();
     }
 
     bool StreamingPipeline::addInput(std::shared_ptr<DataObject> data)
@@ -146,18 +429,225 @@ namespace GryFlux
             return false;
         }
 
-        // 避免队列过大时的内存占用问题
-        while (inputQueue_->size() >= queueMaxSize_ && input_active_.load())
+        // 截止时间从进入管道时开始计算，包含在输入队列中等待的时间
+        if (frameBudget_.count() > 0 && !data->hasDeadline())
         {
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            data->setDeadline(DataObject::Clock::now() + frameBudget_);
         }
 
-        if (input_active_.load())
+        // 被挤出的帧在释放inputMutex_之后再交付，交付占位结果时不阻塞其他生产者
+        std::vector<std::shared_ptr<DataObject>> evictedFrames;
+        bool accepted = false;
+        bool blocked = false;
         {
-            inputQueue_->push(data);
-            return true;
+            std::unique_lock<std::mutex> lock(inputMutex_);
+            for (;;)
+            {
+                // 停止后不再挤出队列中的帧：它们由处理线程取完，不能被当作丢弃交付
+                if (!input_active_.load())
+                {
+                    break;
+                }
+
+                std::shared_ptr<DataObject> evicted;
+                switch (overflowPolicy_)
+                {
+                case InputOverflowPolicy::Block:
+                case InputOverflowPolicy::DropNewest:
+                    break;
+                case InputOverflowPolicy::DropOldest:
+                    while (inputQueue_->size() >= queueMaxSize_ && inputQueue_->try_pop(evicted))
+                    {
+                        inputDroppedOldest_++;
+                        evictedFrames.push_back(std::move(evicted));
+                    }
+                    break;
+                case InputOverflowPolicy::KeepLatest:
+                    while (inputQueue_->try_pop(evicted))
+                    {
+                        inputReplaced_++;
+                        evictedFrames.push_back(std::move(evicted));
+                    }
+                    break;
+                }
+
+                // 按调用addInput的顺序分配帧序号，入队成功后才占用该序号
+                data->setSequence(nextSequence_);
+                if (inputQueue_->try_push(data))
+                {
+                    accepted = true;
+                    break;
+                }
+                if (inputQueue_->closed())
+                {
+                    break;
+                }
+                if (overflowPolicy_ == InputOverflowPolicy::DropNewest)
+                {
+                    inputDroppedNewest_++;
+                    return true;
+                }
+
+                // 队列满时等待处理线程取走输入，等待期间释放inputMutex_；stop()关闭队列时返回
+                if (!blocked)
+                {
+                    blocked = true;
+                    inputBlocked_++;
+                }
+                waitingProducers_.fetch_add(1);
+                // 计数对处理线程可见之后再试一次，避免处理线程在计数之前取走输入而漏掉唤醒
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (inputQueue_->try_push(data))
+                {
+                    waitingProducers_.fetch_sub(1);
+                    accepted = true;
+                    break;
+                }
+                inputNotFull_.wait(lock);
+                waitingProducers_.fetch_sub(1);
+            }
+
+            if (accepted)
+            {
+                nextSequence_++;
+            }
+            if (!evictedFrames.empty())
+            {
+                pendingEvictions_++;
+            }
+        }
+
+        if (!evictedFrames.empty())
+        {
+            for (const auto &evicted : evictedFrames)
+            {
+                deliverResult(evicted->getSequence(), nullptr, FramePlaceholder::Reason::Dropped);
+            }
+            // finishOutput等待所有挤出的帧交付后才释放重排缓冲区
+            std::lock_guard<std::mutex> lock(inputMutex_);
+            if (--pendingEvictions_ == 0)
+            {
+                evictionsDelivered_.notify_all();
+            }
+        }
+
+        if (!accepted)
+        {
+            return false;
+        }
+        inputAccepted_++;
+        return true;
+    }
+
+    void StreamingPipeline::setInputOverflowPolicy(InputOverflowPolicy policy)
+    {
+        if (running_)
+        {
+            throw std::runtime_error("Cannot set input overflow policy while pipeline is running");
         }
-        return false;
+        overflowPolicy_ = policy;
+    }
+
+    StreamingPipeline::DataObjectQueue StreamingPipeline::createQueue(QueueType type, size_t capacity)
+    {
+        using Item = std::shared_ptr<DataObject>;
+        switch (type)
+        {
+        case QueueType::LockFreeMPMC:
+            return std::make_shared<mpmc_queue<Item>>(capacity);
+        case QueueType::LockFreeSPSC:
+            return std::make_shared<spsc_queue<Item>>(capacity);
+        case QueueType::Locked:
+        default:
+            return std::make_shared<threadsafe_queue<Item>>(capacity);
+        }
+    }
+
+    void StreamingPipeline::setInputQueueType(QueueType type)
+    {
+        if (running_)
+        {
+            throw std::runtime_error("Cannot set input queue type while pipeline is running");
+        }
+        inputQueueType_ = type;
+        inputQueue_ = createQueue(type, queueMaxSize_);
+    }
+
+    void StreamingPipeline::setOutputQueueType(QueueType type, size_t capacity)
+    {
+        if (running_)
+        {
+            throw std::runtime_error("Cannot set output queue type while pipeline is running");
+        }
+        // 互斥锁队列作为输出时保持不限容量
+        outputQueueType_ = type;
+        outputQueue_ = createQueue(type, type == QueueType::Locked ? 0 : (capacity > 0 ? capacity : queueMaxSize_));
+    }
+
+    StreamingPipeline::InputQueueStats StreamingPipeline::getInputQueueStats() const
+    {
+        InputQueueStats stats;
+        stats.accepted = inputAccepted_.load();
+        stats.blocked = inputBlocked_.load();
+        stats.droppedNewest = inputDroppedNewest_.load();
+        stats.droppedOldest = inputDroppedOldest_.load();
+        stats.replaced = inputReplaced_.load();
+        return stats;
+    }
+
+    void StreamingPipeline::deliverResult(uint64_t sequence, std::shared_ptr<DataObject> result,
+                                          FramePlaceholder::Reason reason)
+    {
+        if (const auto *outcome = result ? result->as<TaskOutcome>() : nullptr)
+        {
+            // Error与结果为空一样记为失败帧
+            if (outcome->getKind() == TaskOutcome::Kind::Error)
+            {
+                LOG.debug("[Pipeline] Frame %llu failed: %s", static_cast<unsigned long long>(sequence),
+                          outcome->getMessage().c_str());
+            }
+            else
+            {
+                prunedFrames_++;
+                reason = FramePlaceholder::Reason::Pruned;
+            }
+            result.reset();
+        }
+
+        if (result)
+        {
+            result->setSequence(sequence);
+            processedItems_++;
+        }
+
+        if (reorderBuffer_)
+        {
+            reorderBuffer_->submit(sequence, result, reason);
+        }
+        else if (result)
+        {
+            outputQueue_->push(result);
+        }
+    }
+
+    void StreamingPipeline::finishOutput()
+    {
+        if (reorderBuffer_)
+        {
+            // 所有已提交的帧都已交付，仍缺失的帧不会再到达。addInput在inputMutex_下分配序号，
+            // 入队成功才占用序号，加锁读取才能排除被stop()打断、从未进入管道的帧；
+            // 被挤出的帧在锁外交付，等它们交付完毕后再释放重排缓冲区
+            uint64_t endSequence;
+            {
+                std::unique_lock<std::mutex> lock(inputMutex_);
+                evictionsDelivered_.wait(lock, [this]
+                                         { return pendingEvictions_ == 0; });
+                endSequence = nextSequence_;
+            }
+            reorderBuffer_->flush(endSequence);
+        }
+        output_active_ = false;
+        outputQueue_->close();
     }
 
     bool StreamingPipeline::tryGetOutput(std::shared_ptr<DataObject> &output)
@@ -167,7 +657,26 @@ namespace GryFlux
 
     void StreamingPipeline::getOutput(std::shared_ptr<DataObject> &output)
     {
-        outputQueue_->wait_and_pop(output);
+        if (!outputQueue_->pop_wait(output))
+        {
+            output.reset();
+        }
+    }
+
+    bool StreamingPipeline::waitForOutput(std::shared_ptr<DataObject> &output, std::chrono::milliseconds timeout)
+    {
+        return outputQueue_->pop_wait(output, timeout);
+    }
+
+    size_t StreamingPipeline::tryGetOutputBulk(std::shared_ptr<DataObject> *outputs, size_t maxCount)
+    {
+        return outputQueue_->try_pop_bulk(outputs, maxCount);
+    }
+
+    size_t StreamingPipeline::waitForOutputBulk(std::shared_ptr<DataObject> *outputs, size_t maxCount,
+                                                std::chrono::milliseconds timeout)
+    {
+        return outputQueue_->pop_wait_bulk(outputs, maxCount, timeout);
     }
 
     void StreamingPipeline::setOutputNodeId(const std::string &outputId)
@@ -179,6 +688,15 @@ namespace GryFlux
         outputNodeId_ = outputId;
     }
 
+    void StreamingPipeline::setMaxFramesInFlight(size_t maxFrames)
+    {
+        if (running_)
+        {
+            throw std::runtime_error("Cannot set max frames in flight while pipeline is running");
+        }
+        maxFramesInFlight_ = maxFrames > 0 ? maxFrames : 1;
+    }
+
     bool StreamingPipeline::inputEmpty() const
     {
         return inputQueue_->empty();
@@ -214,83 +732,292 @@ namespace GryFlux
         return running_;
     }
 
-    void StreamingPipeline::processingLoop()
+    void StreamingPipeline::collectTaskStats(SlotStats &stats, const TaskScheduler &scheduler)
     {
-        while (running_ || !inputQueue_->empty())
+        for (TaskNode::TaskId id = 0; id < scheduler.getTaskCount(); ++id)
         {
-            std::shared_ptr<DataObject> input;
-            if (inputQueue_->try_pop(input)) // 非阻塞获取输入
+            auto task = scheduler.getTask(id);
+            auto state = task->getState();
+            if (state != TaskNode::State::Done && state != TaskNode::State::Failed)
             {
-                // 只有在启用性能分析时才测量时间
-                std::chrono::time_point<std::chrono::high_resolution_clock> startProcess;
-                if (profilingEnabled_)
+                continue;
+            }
+
+            // 统计按任务序号存放；只有处理函数每帧构建出不同结构的图时才需要按名称查找
+            if (id >= stats.tasks.size())
+            {
+                stats.tasks.resize(id + 1);
+            }
+            TaskStat *stat = &stats.tasks[id];
+            if (stat->count == 0 && stat->name.empty())
+            {
+                stat->name = task->getName();
+            }
+            else if (stat->name != task->getName())
+            {
+                auto it = std::find_if(stats.tasks.begin(), stats.tasks.end(),
+                                       [&task](const TaskStat &entry)
+                                       { return entry.name == task->getName(); });
+                if (it == stats.tasks.end())
                 {
-                    startProcess = std::chrono::high_resolution_clock::now();
+                    stats.tasks.push_back({task->getName(), 0.0, 0});
+                    it = stats.tasks.end() - 1;
                 }
+                stat = &*it;
+            }
 
-                try
-                {
-                    // 使用用户定义的处理器构建和执行管道
-                    processor_(pipelineBuilder_, input, outputNodeId_);
+            // 累加到同名任务的统计中
+            stat->totalTimeMs += task->getExecutionTimeMs();
+            stat->count++;
+        }
+    }
 
-                    // 只有在启用性能分析时才收集任务统计信息
-                    if (profilingEnabled_)
-                    {
-                        auto result = pipelineBuilder_->execute(outputNodeId_);
+    void StreamingPipeline::registerCallers(CallerRegistrations &registrations, std::shared_ptr<SuspendableTask> task,
+                                            size_t count)
+    {
+        if (task)
+        {
+            task->addCallers(count);
+            registrations.emplace_back(std::move(task), count);
+        }
+    }
 
-                        // 收集同名任务的执行时间统计
-                        auto taskTimes = pipelineBuilder_->getScheduler()->getTaskExecutionTimes();
-                        for (const auto &taskTime : taskTimes)
-                        {
-                            const std::string &taskName = taskTime.first;
-                            double executionTime = taskTime.second;
+    void StreamingPipeline::unregisterCallers(CallerRegistrations &registrations)
+    {
+        for (auto &registration : registrations)
+        {
+            registration.first->removeCallers(registration.second);
+        }
+        registrations.clear();
+    }
 
-                            // 累加到同名任务的统计中
-                            taskStats_[taskName].first += executionTime;
-                            taskStats_[taskName].second++;
-                        }
+    void StreamingPipeline::stageFeedLoop()
+    {
+        std::shared_ptr<DataObject> input;
+        while (popInput(input))
+        {
+            if (input->hasDeadline() && DataObject::Clock::now() >= input->getDeadline())
+            {
+                droppedFrames_++;
+                deliverResult(input->getSequence(), nullptr, FramePlaceholder::Reason::Dropped);
+                continue;
+            }
 
-                        // 处理结果
-                        if (result)
-                        {
-                            outputQueue_->push(result);
-                            processedItems_++;
-                        }
+            try
+            {
+                // 第一个阶段队列满时阻塞，背压传递到输入队列
+                stageGraph_->push(input);
+            }
+            catch (const std::exception &e)
+            {
+                errorCount_++;
+                LOG.error("[Pipeline] Error feeding stage graph: %s", e.what());
+                deliverResult(input->getSequence(), nullptr);
+            }
+        }
 
-                        // 计算处理时间
-                        auto endProcess = std::chrono::high_resolution_clock::now();
-                        auto duration = std::chrono::duration<double, std::milli>(endProcess - startProcess).count();
-                        totalProcessingTime_ += duration;
+        // 输入全部送入后排空各阶段，再关闭输出队列
+        stageGraph_->stop();
+        if (--activeProcessingLoops_ == 0)
+        {
+            finishOutput();
+        }
+        LOG.debug("[Pipeline] Stage feed loop completed");
+    }
 
-                        LOG.debug("[Pipeline] Processed item %zu in %.3f ms", processedItems_, duration);
-                    }
-                    else
+    void StreamingPipeline::logStageStats(double totalTimeMs) const
+    {
+        LOG.info("[Pipeline] Stage statistics:");
+
+        // 利用率 = 处理耗时 / (工作线程数 * 运行时间)，利用率最高的阶段即瓶颈
+        const StageGraph::StageStats *bottleneck = nullptr;
+        double maxUtilization = 0.0;
+        auto stageStats = stageGraph_->getStageStats();
+        for (const auto &stat : stageStats)
+        {
+            double avgTime = stat.processed > 0 ? stat.totalTimeMs / stat.processed : 0.0;
+            double utilization = totalTimeMs > 0 ? stat.totalTimeMs / (stat.workers * totalTimeMs) * 100.0 : 0.0;
+            LOG.info("  - Stage [%s]: %zu worker(s), %zu frames, %.3f ms avg, %.1f%% busy, "
+                     "queue max %zu/%zu, upstream blocked %.3f ms, %zu dropped, %zu pruned",
+                     stat.name.c_str(), stat.workers, stat.processed, avgTime, utilization,
+                     stat.maxQueueDepth, stat.queueCapacity, stat.blockedTimeMs, stat.dropped, stat.pruned);
+            if (!stat.policy.isDefault())
+            {
+                LOG.info("    thread policy %s: %s", stat.policy.describe().c_str(),
+                         stat.policyGranted ? "granted" : "NOT granted");
+            }
+            if (!bottleneck || utilization > maxUtilization)
+            {
+                bottleneck = &stat;
+                maxUtilization = utilization;
+            }
+        }
+
+        if (bottleneck)
+        {
+            LOG.info("  - Bottleneck stage: [%s] (%.1f%% busy)", bottleneck->name.c_str(), maxUtilization);
+        }
+    }
+
+    void StreamingPipeline::notifyInputPopped()
+    {
+        // 与addInput中生产者登记等待后的重试配对，二者至少有一方看到对方
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waitingProducers_.load() > 0)
+        {
+            std::lock_guard<std::mutex> lock(inputMutex_);
+            inputNotFull_.notify_one();
+        }
+    }
+
+    bool StreamingPipeline::popInput(std::shared_ptr<DataObject> &input)
+    {
+        // 等待前释放上一帧的输入，空闲时不持有帧数据
+        input.reset();
+        if (!reorderBuffer_ || lateFrameTimeout_.count() <= 0)
+        {
+            if (!inputQueue_->pop_wait(input))
+            {
+                return false;
+            }
+            notifyInputPopped();
+            return true;
+        }
+
+        // 没有新结果提交时由空闲的处理线程检查队首帧的等待超时，等待间隔取超时时间的1/10
+        auto interval = std::max(lateFrameTimeout_ / 10, std::chrono::milliseconds(1));
+        while (!inputQueue_->pop_wait(input, interval))
+        {
+            if (inputQueue_->closed())
+            {
+                return false;
+            }
+            reorderBuffer_->poll();
+        }
+        notifyInputPopped();
+        return true;
+    }
+
+    void StreamingPipeline::processingLoop(size_t slot)
+    {
+        // 每个在途帧槽位持有独立的计算图实例，任务在共享线程池上执行
+        auto pipelineBuilder = std::make_shared<PipelineBuilder>(threadPool_);
+        pipelineBuilder->getScheduler()->setIoExecutor(ioExecutor_);
+        pipelineBuilder->getScheduler()->setTimeEstimates(timeEstimates_);
+        TaskNode::TaskId outputTaskId = TaskNode::kInvalidTaskId;
+        if (graphTemplate_)
+        {
+            // 计算图只实例化一次，之后每帧复用，输出节点序号也只需解析一次
+            pipelineBuilder->instantiate(*graphTemplate_);
+            outputTaskId = pipelineBuilder->getScheduler()->findTaskId(outputNodeId_);
+        }
+
+        // 本槽位独占的统计数据，无需加锁
+        SlotStats &stats = slotStats_[slot];
+        CallerRegistrations callerRegistrations;
+        bool callersRegistered = false;
+
+        std::shared_ptr<DataObject> input;
+        while (popInput(input))
+        {
+            // 在输入队列中已经超时的帧直接丢弃
+            if (input->hasDeadline() && DataObject::Clock::now() >= input->getDeadline())
+            {
+                droppedFrames_++;
+                LOG.debug("[Pipeline] Frame %llu expired in input queue, dropped",
+                          static_cast<unsigned long long>(input->getSequence()));
+                deliverResult(input->getSequence(), nullptr, FramePlaceholder::Reason::Dropped);
+                continue;
+            }
+
+            // 只有在启用性能分析时才测量时间
+            std::chrono::time_point<std::chrono::high_resolution_clock> startProcess;
+            if (profilingEnabled_)
+            {
+                startProcess = std::chrono::high_resolution_clock::now();
+            }
+
+            try
+            {
+                std::shared_ptr<DataObject> result;
+                auto scheduler = pipelineBuilder->getScheduler();
+                scheduler->setDeadline(input->getDeadline());
+                if (graphTemplate_)
+                {
+                    // 复用模板实例，只绑定本帧输入
+                    pipelineBuilder->bindInput(input);
+                    result = pipelineBuilder->execute(outputTaskId);
+                }
+                else
+                {
+                    // 使用用户定义的处理器构建和执行管道
+                    processor_(pipelineBuilder, input, outputNodeId_);
+                    if (!callersRegistered)
                     {
-                        // 在不启用性能分析时，直接执行管道并处理结果
-                        auto result = pipelineBuilder_->execute(outputNodeId_);
-                        if (result)
+                        // 处理函数构建的计算图在第一帧之后才知道，本槽位按一个调用方登记其中的可挂起任务
+                        callersRegistered = true;
+                        for (size_t id = 0; id < scheduler->getTaskCount(); ++id)
                         {
-                            outputQueue_->push(result);
-                            processedItems_++;
+                            auto node = std::dynamic_pointer_cast<MultiInputTaskNode>(scheduler->getTask(id));
+                            if (node)
+                            {
+                                registerCallers(callerRegistrations, node->getSuspendableTask(), 1);
+                            }
                         }
                     }
+                    result = pipelineBuilder->execute(outputNodeId_);
+                }
+
+                // 只有在启用性能分析时才收集任务统计信息
+                double duration = 0.0;
+                if (profilingEnabled_)
+                {
+                    collectTaskStats(stats, *pipelineBuilder->getScheduler());
+
+                    // 计算处理时间
+                    auto endProcess = std::chrono::high_resolution_clock::now();
+                    duration = std::chrono::duration<double, std::milli>(endProcess - startProcess).count();
+                    stats.totalProcessingTime += duration;
+                }
+
+                // 处理结果，因截止时间取消的帧计为丢弃
+                if (scheduler->wasCancelled())
+                {
+                    droppedFrames_++;
+                    deliverResult(input->getSequence(), nullptr, FramePlaceholder::Reason::Dropped);
                 }
-                catch (const std::exception &e)
+                else
                 {
-                    errorCount_++;
-                    LOG.error("[Pipeline] Error processing input: %s", e.what());
+                    deliverResult(input->getSequence(), result);
                 }
-                catch (...)
+
+                if (profilingEnabled_)
                 {
-                    errorCount_++;
-                    LOG.error("[Pipeline] Unknown error processing input");
+                    LOG.debug("[Pipeline] Slot %zu processed item %zu in %.3f ms", slot, processedItems_, duration);
                 }
             }
+            catch (const std::exception &e)
+            {
+                errorCount_++;
+                LOG.error("[Pipeline] Error processing input: %s", e.what());
+                deliverResult(input->getSequence(), nullptr);
+            }
+            catch (...)
+            {
+                errorCount_++;
+                LOG.error("[Pipeline] Unknown error processing input");
+                deliverResult(input->getSequence(), nullptr);
+            }
         }
 
-        // 处理完所有输入后，关闭输出队列
-        output_active_ = false;
-        LOG.debug("[Pipeline] Processing loop completed");
+        unregisterCallers(callerRegistrations);
+
+        // 最后一个处理线程完成所有输入后，关闭输出队列
+        if (--activeProcessingLoops_ == 0)
+        {
+            finishOutput();
+        }
+        LOG.debug("[Pipeline] Processing loop %zu completed", slot);
     }
 
 } // namespace GryFlux
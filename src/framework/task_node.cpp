@@ -16,20 +16,100 @@
  *************************************************************************************************************************/
 #include "framework/task_node.h"
 #include <algorithm>
-#include <mutex>
+#include <utility>
+#include "framework/exclusive_inputs.h"
 #include "utils/logger.h"
 
 namespace GryFlux
 {
 
+    namespace
+    {
+        // 结果是否就是某个未移交所有权的输入对象
+        bool aliasesSharedInput(const DataObject *result, const std::vector<std::shared_ptr<DataObject>> &inputs,
+                                uint64_t exclusive)
+        {
+            for (size_t i = 0; result && i < inputs.size(); ++i)
+            {
+                if (inputs[i].get() == result && (exclusive & ExclusiveInputs::bit(i)) == 0)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+    } // namespace
+
+    EdgeCondition classifyResult(const std::shared_ptr<DataObject> &result)
+    {
+        if (!result)
+        {
+            return EdgeCondition::OnError;
+        }
+        const auto *outcome = result->as<TaskOutcome>();
+        if (!outcome)
+        {
+            return EdgeCondition::OnValue;
+        }
+        switch (outcome->getKind())
+        {
+        case TaskOutcome::Kind::Skip:
+            return EdgeCondition::OnSkip;
+        case TaskOutcome::Kind::Empty:
+            return EdgeCondition::OnEmpty;
+        default:
+            return EdgeCondition::OnError;
+        }
+    }
+
+    void EdgeConditionCheck::add(const std::shared_ptr<DataObject> &input, EdgeCondition condition)
+    {
+        EdgeCondition category = classifyResult(input);
+        if (hasCondition(condition, category))
+        {
+            return;
+        }
+
+        // 类别的位值恰好按Skip < Empty < Error递增，可直接作为优先级
+        std::shared_ptr<DataObject> outcome;
+        if (hasCondition(condition, EdgeCondition::OnValue))
+        {
+            // 普通数据边：传播前驱的条件输出
+            outcome = input ? input : TaskOutcome::error();
+        }
+        else
+        {
+            // 分支边未被选中
+            category = EdgeCondition::OnSkip;
+        }
+
+        uint8_t severity = static_cast<uint8_t>(category);
+        if (severity > severity_)
+        {
+            severity_ = severity;
+            pruned_ = outcome ? std::move(outcome) : TaskOutcome::skip();
+        }
+    }
+
     // TaskNode基类实现
-    TaskNode::TaskNode(TaskId id) : id_(id), executed_(false), executionTimeMs_(0.0) {}
+    TaskNode::TaskNode(std::string name)
+        : id_(kInvalidTaskId), name_(std::move(name)), state_(State::Pending), executionTimeMs_(0.0) {}
 
     TaskNode::TaskId TaskNode::getId() const
     {
         return id_;
     }
 
+    void TaskNode::setId(TaskId id)
+    {
+        id_ = id;
+    }
+
+    const std::string &TaskNode::getName() const
+    {
+        return name_;
+    }
+
     void TaskNode::addDependency(std::shared_ptr<TaskNode> node)
     {
         if (node)
@@ -45,23 +125,119 @@ namespace GryFlux
 
     void TaskNode::setResult(std::shared_ptr<DataObject> result)
     {
-        std::lock_guard<std::recursive_mutex> lock(mutex_);
-        result_ = result;
-        executed_ = true;
+        result_ = std::move(result);
+        // release：保证结果在状态变为Done之前对其他线程可见
+        state_.store(State::Done, std::memory_order_release);
     }
 
-    std::shared_ptr<DataObject> TaskNode::getResult()
+    std::shared_ptr<DataObject> TaskNode::getResult() const
     {
-        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        State state = state_.load(std::memory_order_acquire);
+        if (state != State::Done && state != State::Skipped)
+        {
+            return nullptr;
+        }
         return result_;
     }
 
+    void TaskNode::releaseResult()
+    {
+        result_.reset();
+    }
+
+    std::shared_ptr<DataObject> TaskNode::takeResult()
+    {
+        State state = state_.load(std::memory_order_acquire);
+        if (state != State::Done && state != State::Skipped)
+        {
+            return nullptr;
+        }
+        return std::move(result_);
+    }
+
+    void TaskNode::setInputTransferable(size_t position, bool transferable)
+    {
+        if (position >= transferableInputs_.size())
+        {
+            transferableInputs_.resize(std::max(dependencies_.size(), position + 1), 0);
+        }
+        transferableInputs_[position] = transferable ? 1 : 0;
+    }
+
+    bool TaskNode::isInputTransferable(size_t position) const
+    {
+        return position < transferableInputs_.size() && transferableInputs_[position] != 0;
+    }
+
+    bool TaskNode::isResultShared() const
+    {
+        return resultShared_;
+    }
+
+    void TaskNode::setInputCondition(size_t position, EdgeCondition condition)
+    {
+        if (position >= inputConditions_.size())
+        {
+            inputConditions_.resize(std::max(dependencies_.size(), position + 1), EdgeCondition::OnValue);
+        }
+        inputConditions_[position] = condition;
+    }
+
+    EdgeCondition TaskNode::getInputCondition(size_t position) const
+    {
+        return position < inputConditions_.size() ? inputConditions_[position] : EdgeCondition::OnValue;
+    }
+
+    void TaskNode::setKind(TaskKind kind)
+    {
+        kind_ = kind;
+    }
+
+    TaskKind TaskNode::getKind() const
+    {
+        return kind_;
+    }
+
+    std::shared_ptr<DataObject> TaskNode::checkInputConditions() const
+    {
+        EdgeConditionCheck check;
+        for (size_t i = 0; i < dependencies_.size(); ++i)
+        {
+            check.add(dependencies_[i]->getResult(), getInputCondition(i));
+        }
+        return check.getPrunedResult();
+    }
+
+    bool TaskNode::prune(std::shared_ptr<DataObject> outcome)
+    {
+        State expected = State::Pending;
+        if (!state_.compare_exchange_strong(expected, State::Running,
+                                            std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            return false;
+        }
+        result_ = std::move(outcome);
+        state_.store(State::Skipped, std::memory_order_release);
+        return true;
+    }
+
+    TaskNode::State TaskNode::getState() const
+    {
+        return state_.load(std::memory_order_acquire);
+    }
+
     bool TaskNode::isExecuted() const
     {
-        // 使用互斥锁保护任务执行过程
-        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        State state = state_.load(std::memory_order_acquire);
+        return state == State::Done || state == State::Failed || state == State::Cancelled ||
+               state == State::Skipped;
+    }
 
-        return executed_;
+    bool TaskNode::cancel()
+    {
+        State expected = State::Pending;
+        return state_.compare_exchange_strong(expected, State::Cancelled,
+                                              std::memory_order_acq_rel, std::memory_order_acquire);
     }
 
     bool TaskNode::isReady() const
@@ -99,105 +275,180 @@ namespace GryFlux
 
     void TaskNode::executeOnce()
     {
-        // 使用互斥锁保护任务执行过程
-        std::lock_guard<std::recursive_mutex> lock(mutex_);
-        
-        // 再次检查是否已执行，以防在等待依赖时被其他线程执行
-        if (isExecuted()) {
+        // 只有成功从Pending切换到Running的线程执行任务，保证同一个任务不会被多次执行
+        State expected = State::Pending;
+        if (!state_.compare_exchange_strong(expected, State::Running,
+                                            std::memory_order_acq_rel, std::memory_order_acquire))
+        {
             return;
         }
 
         // 记录任务开始执行时间
         startExecution();
-        
+
         // 执行当前任务
-        auto result = execute();
-        
+        std::shared_ptr<DataObject> result;
+        try
+        {
+            result = execute();
+        }
+        catch (...)
+        {
+            endExecution();
+            state_.store(State::Failed, std::memory_order_release);
+            throw;
+        }
+
         // 记录任务结束执行时间
         endExecution();
 
         // 设置结果（必须在记录结束时间之后）
         setResult(result);
-        
+
         // 记录执行时间
-        LOG.debug("Task [%s] executed in %.3f ms", getId().c_str(), getExecutionTimeMs());
+        LOG.debug("Task [%s] executed in %.3f ms", getName().c_str(), getExecutionTimeMs());
 
     }
 
-    double TaskNode::getExecutionTimeMs() const
+    bool TaskNode::executeAsync(Executor &, uint64_t, std::function<void()>)
+    {
+        executeOnce();
+        return true;
+    }
+
+    void TaskNode::reset()
     {
-        // 使用互斥锁保护任务执行过程
-        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        result_.reset();
+        resultShared_ = false;
+        std::fill(transferableInputs_.begin(), transferableInputs_.end(), 0);
+        executionTimeMs_ = 0.0;
+        state_.store(State::Pending, std::memory_order_release);
+    }
 
+    double TaskNode::getExecutionTimeMs() const
+    {
+        // acquire与执行线程发布状态时的release配对
+        if (!isExecuted())
+        {
+            return 0.0;
+        }
         return executionTimeMs_;
     }
 
     // InputNode实现
-    InputNode::InputNode(TaskId id, std::shared_ptr<DataObject> data)
-        : TaskNode(id), data_(data)
+    // 输入数据只由result_持有：调度器把输入节点计入读取者计数，最后一个读取者可以取得独占所有权
+    InputNode::InputNode(std::string name, std::shared_ptr<DataObject> data)
+        : TaskNode(std::move(name))
     {
-        setResult(data);
+        setResult(std::move(data));
     }
 
     std::shared_ptr<DataObject> InputNode::execute()
     {
-        return data_;
+        return result_;
+    }
+
+    void InputNode::bind(std::shared_ptr<DataObject> data)
+    {
+        setResult(std::move(data));
+    }
+
+    void InputNode::reset()
+    {
+        // 输入节点始终处于已执行状态，只释放上一帧的数据
+        bind(nullptr);
     }
 
     // MultiInputTaskNode实现
-    MultiInputTaskNode::MultiInputTaskNode(TaskId id, ProcessFunction func,
-                                           const std::vector<std::shared_ptr<TaskNode>> &inputs)
-        : TaskNode(id), func_(func), inputs_(inputs)
+    MultiInputTaskNode::MultiInputTaskNode(std::string name, ProcessFunction func,
+                                           const std::vector<std::shared_ptr<TaskNode>> &inputs,
+                                           const std::vector<EdgeCondition> &conditions)
+        : TaskNode(std::move(name)), func_(func), suspendable_(SuspendableTask::from(func_)), inputs_(inputs)
     {
-        for (const auto &input : inputs)
+        for (size_t i = 0; i < inputs.size(); ++i)
         {
-            if (input)
+            if (inputs[i])
             {
-                addDependency(input);
+                if (i < conditions.size())
+                {
+                    setInputCondition(dependencies_.size(), conditions[i]);
+                }
+                addDependency(inputs[i]);
             }
         }
     }
 
-    std::shared_ptr<DataObject> MultiInputTaskNode::execute()
+    bool MultiInputTaskNode::collectInputs(std::vector<std::shared_ptr<DataObject>> &inputs, uint64_t &exclusive)
     {
+        exclusive = 0;
         if (!isReady() || getDependencies().empty())
         {
-            LOG.warning("Task [%s] not ready or has no dependencies", getId().c_str());
-            return nullptr;
+            LOG.warning("Task [%s] not ready or has no dependencies", getName().c_str());
+            return false;
         }
 
-        try {
-            std::vector<std::shared_ptr<DataObject>> inputResults;
-            
-            // 安全地获取所有依赖结果
-            for (const auto &dep : getDependencies())
-            {
-                if (!dep) {
-                    LOG.error("Null dependency in task [%s]", getId().c_str());
-                    continue;
-                }
-                
-                auto result = dep->getResult();
-                inputResults.push_back(result);
+        // 安全地获取所有依赖结果；本节点是唯一剩余读取者的依赖直接移交所有权，不增加引用
+        const auto &dependencies = getDependencies();
+        for (size_t i = 0; i < dependencies.size(); ++i)
+        {
+            const auto &dep = dependencies[i];
+            if (!dep) {
+                LOG.error("Null dependency in task [%s]", getName().c_str());
+                continue;
             }
 
-            // 检查是否所有输入都有效
-            if (std::any_of(inputResults.begin(), inputResults.end(),
-                            [](const std::shared_ptr<DataObject> &obj)
-                            { return !obj; }))
+            std::shared_ptr<DataObject> input;
+            if (isInputTransferable(i) && (input = dep->takeResult()))
             {
-                LOG.warning("Some input results are null for task [%s]", getId().c_str());
-                return nullptr;
+                exclusive |= ExclusiveInputs::bit(i);
+            }
+            else
+            {
+                input = dep->getResult();
+            }
+            // 接受错误的输入边上，失败的前驱以TaskOutcome::error()交给处理函数
+            if (!input && hasCondition(getInputCondition(i), EdgeCondition::OnError))
+            {
+                input = TaskOutcome::error();
             }
+            inputs.push_back(std::move(input));
+        }
 
-            // 确保处理函数存在
-            if (!func_) {
-                LOG.error("Process function is null for task [%s]", getId().c_str());
+        // 检查是否所有输入都有效
+        if (std::any_of(inputs.begin(), inputs.end(),
+                        [](const std::shared_ptr<DataObject> &obj)
+                        { return !obj; }))
+        {
+            LOG.warning("Some input results are null for task [%s]", getName().c_str());
+            return false;
+        }
+
+        // 确保处理函数存在
+        if (!func_) {
+            LOG.error("Process function is null for task [%s]", getName().c_str());
+            return false;
+        }
+        return true;
+    }
+
+    std::shared_ptr<DataObject> MultiInputTaskNode::execute()
+    {
+        try {
+            std::vector<std::shared_ptr<DataObject>> inputResults;
+            uint64_t exclusive;
+            if (!collectInputs(inputResults, exclusive))
+            {
                 return nullptr;
             }
 
-            // 执行任务处理函数
-            return func_(inputResults);
+            // 执行任务处理函数，期间takeInput可以原地修改移交了所有权的输入
+            std::shared_ptr<DataObject> result;
+            {
+                ExclusiveInputs::Scope scope(exclusive);
+                result = func_(inputResults);
+            }
+            resultShared_ = aliasesSharedInput(result.get(), inputResults, exclusive);
+            return result;
         } catch (const std::exception& e) {
             LOG.error("Exception in MultiInputTaskNode::execute: %s", e.what());
             return nullptr;
@@ -207,6 +458,92 @@ namespace GryFlux
         }
     }
 
+    bool MultiInputTaskNode::executeAsync(Executor &executor, uint64_t priority, std::function<void()> done)
+    {
+        if (!suspendable_)
+        {
+            return TaskNode::executeAsync(executor, priority, std::move(done));
+        }
+
+        State expected = State::Pending;
+        if (!state_.compare_exchange_strong(expected, State::Running,
+                                            std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            return true;
+        }
+
+        // 挂起的执行从这里开始计时，等待实例或批次的时间同样计入节点耗时
+        startExecution();
+        std::vector<std::shared_ptr<DataObject>> inputResults;
+        uint64_t exclusive = 0;
+        std::shared_ptr<DataObject> result;
+        std::exception_ptr error;
+        try
+        {
+            if (collectInputs(inputResults, exclusive))
+            {
+                // 挂起的调用完成时输入可能已释放，只记下未独占的输入地址用于判断结果是否共享
+                std::vector<const DataObject *> sharedInputs;
+                for (size_t i = 0; i < inputResults.size(); ++i)
+                {
+                    if ((exclusive & ExclusiveInputs::bit(i)) == 0)
+                    {
+                        sharedInputs.push_back(inputResults[i].get());
+                    }
+                }
+
+                ExclusiveInputs::Scope scope(exclusive);
+                if (!suspendable_->invoke(inputResults, result, executor, priority,
+                                          [this, done = std::move(done), sharedInputs = std::move(sharedInputs)](
+                                              std::shared_ptr<DataObject> suspendedResult, std::exception_ptr suspendedError)
+                                          {
+                                              bool shared = suspendedResult &&
+                                                            std::find(sharedInputs.begin(), sharedInputs.end(),
+                                                                      suspendedResult.get()) != sharedInputs.end();
+                                              completeSuspended(std::move(suspendedResult), suspendedError, shared);
+                                              done();
+                                          }))
+                {
+                    return false;
+                }
+            }
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+        bool shared = aliasesSharedInput(result.get(), inputResults, exclusive);
+        completeSuspended(std::move(result), error, shared);
+        return true;
+    }
+
+    void MultiInputTaskNode::completeSuspended(std::shared_ptr<DataObject> result, std::exception_ptr error,
+                                               bool resultShared)
+    {
+        if (error)
+        {
+            try
+            {
+                std::rethrow_exception(error);
+            }
+            catch (const std::exception &e)
+            {
+                LOG.error("Exception in MultiInputTaskNode::execute: %s", e.what());
+            }
+            catch (...)
+            {
+                LOG.error("Unknown exception in MultiInputTaskNode::execute");
+            }
+            result.reset();
+            resultShared = false;
+        }
+
+        resultShared_ = resultShared;
+        endExecution();
+        setResult(std::move(result));
+        LOG.debug("Task [%s] executed in %.3f ms", getName().c_str(), getExecutionTimeMs());
+    }
+
     bool MultiInputTaskNode::isReady() const
     {
         return TaskNode::isReady() && !getDependencies().empty();
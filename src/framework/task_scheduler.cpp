@@ -17,116 +17,593 @@
 #include "framework/task_scheduler.h"
 #include "utils/logger.h"
 #include <iostream>
-#include <unordered_set>
-#include <queue>
+#include <string>
 #include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <algorithm>
+#include <stdexcept>
 
 namespace GryFlux
 {
-    // 添加互斥锁用于保护任务执行
-    std::mutex taskExecutionMutex;
+    struct TaskScheduler::ExecutionContext
+    {
+        std::vector<std::shared_ptr<TaskNode>> nodes;
+        std::vector<std::vector<size_t>> successors;
+        // 按依赖位置排列的前驱：子图内的节点，或排在nodes之后的输入节点，其余不在子图中的为kInvalidTaskId
+        std::vector<std::vector<size_t>> predecessors;
+        // 子图读取的输入节点：已处于完成状态，不执行，只参与读取者计数
+        std::vector<std::shared_ptr<TaskNode>> sources;
+        std::vector<size_t> dependencyCounts; // 每个节点在子图内的前驱数量
+        std::vector<size_t> readyTasks;       // 没有前驱、可立即提交的节点
+        std::vector<size_t> topologicalOrder; // 子图内节点的拓扑序，逆序遍历即可计算剩余关键路径
+        std::unique_ptr<std::atomic<size_t>[]> pendingDependencies;
+        // 每个节点与输入节点尚未执行完的读取者数量，归零时释放其结果，只剩一个时结果可以移交给该读取者
+        std::unique_ptr<std::atomic<size_t>[]> pendingConsumers;
+        std::vector<size_t> consumerCounts; // pendingConsumers的初始值
+
+        // 序号为index的前驱节点，index可以指向sources
+        TaskNode &predecessor(size_t index) const
+        {
+            return index < nodes.size() ? *nodes[index] : *sources[index - nodes.size()];
+        }
 
-    TaskScheduler::TaskScheduler(size_t numThreads)
-        : threadPool_(numThreads) {}
+        // 本次执行的截止时间
+        DataObject::Clock::time_point deadline = DataObject::Clock::time_point::max();
+        // 各节点的线程池优先级，数值越小越先执行，见updatePriorities
+        std::vector<uint64_t> priorities;
+        std::atomic<bool> cancelled{false};
 
-    void TaskScheduler::addTask(std::shared_ptr<TaskNode> task)
+        // 尚未完成的节点数量，归零时唤醒等待中的execute调用方
+        std::atomic<size_t> remaining{0};
+        std::mutex doneMutex;
+        std::condition_variable doneCondition;
+    };
+
+    std::atomic<double> &TaskTimeEstimates::slot(const std::string &name)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return slots_.try_emplace(name, 0.0).first->second;
+    }
+
+    void TaskTimeEstimates::record(std::atomic<double> &expected, double elapsedMs)
+    {
+        // 多个在途帧可能同时更新同一节点的估计
+        double current = expected.load(std::memory_order_relaxed);
+        double next;
+        do
+        {
+            next = current > 0.0 ? current * 0.8 + elapsedMs * 0.2 : elapsedMs;
+        } while (!expected.compare_exchange_weak(current, next, std::memory_order_relaxed));
+    }
+
+    TaskScheduler::TaskScheduler(size_t numThreads, ThreadPoolType poolType)
+        : threadPool_(createThreadPool(numThreads, poolType)) {}
+
+    TaskScheduler::TaskScheduler(std::shared_ptr<Executor> threadPool)
+        : threadPool_(threadPool ? threadPool : createThreadPool(0)) {}
+
+    TaskScheduler::TaskId TaskScheduler::addTask(std::shared_ptr<TaskNode> task)
     {
         if (!task)
         {
-            return;
+            return TaskNode::kInvalidTaskId;
+        }
+
+        TaskId id;
+        auto it = taskIndices_.find(task->getName());
+        if (it != taskIndices_.end())
+        {
+            id = it->second;
+            tasks_[id] = task;
+        }
+        else
+        {
+            id = tasks_.size();
+            taskIndices_[task->getName()] = id;
+            tasks_.push_back(task);
+            expectedTimeMs_.push_back(&timeEstimates_->slot(task->getName()));
         }
-        tasks_[task->getId()] = task;
+        task->setId(id);
+
+        compiledOutput_ = TaskNode::kInvalidTaskId;
+        compiledContext_.reset();
+        return id;
     }
 
-    std::shared_ptr<TaskNode> TaskScheduler::getTask(const std::string &id)
+    void TaskScheduler::setTimeEstimates(std::shared_ptr<TaskTimeEstimates> estimates)
     {
-        auto it = tasks_.find(id);
-        if (it != tasks_.end())
+        if (!estimates)
+        {
+            throw std::runtime_error("Task time estimates must not be null");
+        }
+        timeEstimates_ = std::move(estimates);
+        for (size_t id = 0; id < tasks_.size(); ++id)
         {
-            return it->second;
+            expectedTimeMs_[id] = &timeEstimates_->slot(tasks_[id]->getName());
         }
-        return nullptr;
+    }
+
+    TaskScheduler::TaskId TaskScheduler::findTaskId(const std::string &name) const
+    {
+        auto it = taskIndices_.find(name);
+        return it != taskIndices_.end() ? it->second : TaskNode::kInvalidTaskId;
+    }
+
+    std::shared_ptr<TaskNode> TaskScheduler::getTask(const std::string &name)
+    {
+        return getTask(findTaskId(name));
+    }
+
+    std::shared_ptr<TaskNode> TaskScheduler::getTask(TaskId id) const
+    {
+        return id < tasks_.size() ? tasks_[id] : nullptr;
     }
 
     std::shared_ptr<DataObject> TaskScheduler::execute(const std::string &outputTaskId)
+    {
+        TaskId id = findTaskId(outputTaskId);
+        if (id == TaskNode::kInvalidTaskId)
+        {
+            LOG.error("Task not found: %s", outputTaskId.c_str());
+            return nullptr;
+        }
+        return execute(id);
+    }
+
+    std::shared_ptr<DataObject> TaskScheduler::execute(TaskId outputTaskId)
     {
         auto outputTask = getTask(outputTaskId);
         if (!outputTask)
         {
-            LOG.error("Task not found: %s", outputTaskId.c_str());
+            LOG.error("Task not found: #%zu", outputTaskId);
             return nullptr;
         }
 
-        executeTask(outputTask);
+        std::shared_ptr<ExecutionContext> context;
+        if (compiledContext_ && compiledOutput_ == outputTaskId)
+        {
+            // 复用已编译的执行计划，只需恢复计数
+            context = compiledContext_;
+            resetExecutionContext(*context);
+        }
+        else
+        {
+            context = buildExecutionContext(outputTask);
+        }
+
+        cancelled_ = false;
+        if (context->nodes.empty())
+        {
+            return outputTask->getResult();
+        }
+
+        context->deadline = deadline_;
+        updatePriorities(*context);
+
+        // 提交所有没有未完成前驱的节点，其余节点由前驱完成时推送；剩余关键路径最长的先提交
+        std::sort(context->readyTasks.begin(), context->readyTasks.end(), [&context](size_t a, size_t b)
+                  { return context->priorities[a] < context->priorities[b]; });
+        for (size_t index : context->readyTasks)
+        {
+            submitTask(context, index);
+        }
+
+        // 调用方线程只等待最终完成，不占用线程池中的工作线程
+        {
+            std::unique_lock<std::mutex> lock(context->doneMutex);
+            context->doneCondition.wait(lock, [&context]
+                                        { return context->remaining.load(std::memory_order_acquire) == 0; });
+        }
 
+        cancelled_ = context->cancelled.load(std::memory_order_relaxed);
         return outputTask->getResult();
     }
 
-    void TaskScheduler::executeTask(std::shared_ptr<TaskNode> task)
+    std::shared_ptr<TaskScheduler::ExecutionContext> TaskScheduler::buildExecutionContext(const std::shared_ptr<TaskNode> &outputTask)
+    {
+        auto context = std::make_shared<ExecutionContext>();
+
+        // 任务序号到子图内序号的映射，不在子图中的为kInvalidTaskId
+        std::vector<size_t> indices(tasks_.size(), TaskNode::kInvalidTaskId);
+        auto localIndex = [this, &indices](const std::shared_ptr<TaskNode> &task)
+        {
+            TaskId id = task->getId();
+            return id < tasks_.size() && tasks_[id] == task ? indices[id] : TaskNode::kInvalidTaskId;
+        };
+
+        // 从输出节点反向遍历，收集所有尚未执行的节点
+        std::vector<std::shared_ptr<TaskNode>> stack{outputTask};
+        while (!stack.empty())
+        {
+            auto task = stack.back();
+            stack.pop_back();
+            if (!task || task->isExecuted())
+            {
+                continue;
+            }
+            TaskId id = task->getId();
+            if (id >= tasks_.size() || tasks_[id] != task)
+            {
+                LOG.error("Task [%s] is not registered in the scheduler", task->getName().c_str());
+                continue;
+            }
+            if (indices[id] != TaskNode::kInvalidTaskId)
+            {
+                continue;
+            }
+            indices[id] = context->nodes.size();
+            context->nodes.push_back(task);
+            for (const auto &dep : task->getDependencies())
+            {
+                stack.push_back(dep);
+            }
+        }
+
+        // 子图读取的输入节点排在子图节点之后，与子图节点一起按读取者计数
+        size_t nodeCount = context->nodes.size();
+        auto sourceIndex = [this, &context, &indices, nodeCount](const std::shared_ptr<TaskNode> &task)
+        {
+            TaskId id = task->getId();
+            if (id >= tasks_.size() || tasks_[id] != task || !dynamic_cast<const InputNode *>(task.get()))
+            {
+                return TaskNode::kInvalidTaskId;
+            }
+            if (indices[id] == TaskNode::kInvalidTaskId)
+            {
+                indices[id] = nodeCount + context->sources.size();
+                context->sources.push_back(task);
+                context->consumerCounts.push_back(0);
+            }
+            return indices[id];
+        };
+
+        // 建立后继关系与待完成前驱计数，已执行的依赖不计入
+        context->successors.resize(nodeCount);
+        context->predecessors.resize(nodeCount);
+        context->dependencyCounts.assign(nodeCount, 0);
+        context->consumerCounts.assign(nodeCount, 0);
+        for (size_t i = 0; i < nodeCount; ++i)
+        {
+            for (const auto &dep : context->nodes[i]->getDependencies())
+            {
+                size_t depIndex = dep ? localIndex(dep) : TaskNode::kInvalidTaskId;
+                if (dep && depIndex == TaskNode::kInvalidTaskId)
+                {
+                    depIndex = sourceIndex(dep);
+                }
+                context->predecessors[i].push_back(depIndex);
+                if (depIndex == TaskNode::kInvalidTaskId)
+                {
+                    continue;
+                }
+                context->consumerCounts[depIndex]++;
+                if (depIndex < nodeCount)
+                {
+                    context->successors[depIndex].push_back(i);
+                    context->dependencyCounts[i]++;
+                }
+            }
+        }
+
+        // 子图外尚未执行的节点之后还会读取输入节点，这些读取者不会在本次执行中完成，输入节点的结果不释放也不移交
+        for (const auto &task : tasks_)
+        {
+            TaskId id = task->getId();
+            if ((indices[id] != TaskNode::kInvalidTaskId && indices[id] < nodeCount) || task->isExecuted())
+            {
+                continue;
+            }
+            for (const auto &dep : task->getDependencies())
+            {
+                size_t depIndex = dep ? localIndex(dep) : TaskNode::kInvalidTaskId;
+                if (depIndex != TaskNode::kInvalidTaskId && depIndex >= nodeCount)
+                {
+                    context->consumerCounts[depIndex]++;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < context->nodes.size(); ++i)
+        {
+            if (context->dependencyCounts[i] == 0)
+            {
+                context->readyTasks.push_back(i);
+            }
+        }
+
+        // 按前驱计数逐层剥离得到拓扑序
+        std::vector<size_t> counts = context->dependencyCounts;
+        context->topologicalOrder = context->readyTasks;
+        for (size_t i = 0; i < context->topologicalOrder.size(); ++i)
+        {
+            for (size_t successor : context->successors[context->topologicalOrder[i]])
+            {
+                if (--counts[successor] == 0)
+                {
+                    context->topologicalOrder.push_back(successor);
+                }
+            }
+        }
+        context->priorities.assign(context->nodes.size(), TaskQueue::kNoPriority);
+
+        context->pendingDependencies.reset(new std::atomic<size_t>[context->nodes.size()]);
+        context->pendingConsumers.reset(new std::atomic<size_t>[context->consumerCounts.size()]);
+        resetExecutionContext(*context);
+        return context;
+    }
+
+    void TaskScheduler::resetExecutionContext(ExecutionContext &context)
     {
-        // 防止空指针解引用
-        if (!task) {
-            LOG.error("Attempted to execute null task");
-            return;
+        for (size_t i = 0; i < context.nodes.size(); ++i)
+        {
+            context.pendingDependencies[i].store(context.dependencyCounts[i], std::memory_order_relaxed);
         }
-        
-        // 如果任务已经执行过，则直接返回
-        if (task->isExecuted())
+        for (size_t i = 0; i < context.consumerCounts.size(); ++i)
         {
-            return;
+            context.pendingConsumers[i].store(context.consumerCounts[i], std::memory_order_relaxed);
         }
+        context.remaining.store(context.nodes.size(), std::memory_order_relaxed);
+        context.cancelled.store(false, std::memory_order_relaxed);
+    }
 
-        // 首先执行所有依赖任务
-        std::vector<std::future<void>> futures;
-        for (const auto &dep : task->getDependencies())
+    void TaskScheduler::compile(const std::string &outputTaskId)
+    {
+        TaskId id = findTaskId(outputTaskId);
+        if (id == TaskNode::kInvalidTaskId)
+        {
+            throw std::runtime_error("Task not found: " + outputTaskId);
+        }
+        compile(id);
+    }
+
+    void TaskScheduler::compile(TaskId outputTaskId)
+    {
+        auto outputTask = getTask(outputTaskId);
+        if (!outputTask)
+        {
+            throw std::runtime_error("Task not found: #" + std::to_string(outputTaskId));
+        }
+        compiledContext_ = buildExecutionContext(outputTask);
+        compiledOutput_ = outputTaskId;
+    }
+
+    void TaskScheduler::resetTasks()
+    {
+        for (auto &task : tasks_)
+        {
+            task->reset();
+        }
+    }
+
+    void TaskScheduler::updatePriorities(ExecutionContext &context) const
+    {
+        // 剩余关键路径：节点自身的预计耗时加上后继中最长的剩余关键路径，按拓扑逆序计算
+        auto &pathNs = context.priorities;
+        for (size_t i = context.topologicalOrder.size(); i-- > 0;)
         {
-            if (dep && !dep->isExecuted())
+            size_t index = context.topologicalOrder[i];
+            uint64_t longest = 0;
+            for (size_t successor : context.successors[index])
+            {
+                longest = std::max(longest, pathNs[successor]);
+            }
+            double expectedMs = expectedTimeMs_[context.nodes[index]->getId()]->load(std::memory_order_relaxed);
+            pathNs[index] = longest + kNodeOverheadNs + static_cast<uint64_t>(expectedMs * 1e6);
+        }
+
+        // 优先级为最晚开始时刻 = 参考时刻 - 剩余关键路径：同一帧内剩余路径越长越先开始，
+        // 不同帧之间截止时间越早（没有截止时间时提交越早）越先执行
+        auto reference = context.deadline != DataObject::Clock::time_point::max() ? context.deadline
+                                                                                   : DataObject::Clock::now();
+        uint64_t referenceNs = static_cast<uint64_t>(reference.time_since_epoch() / std::chrono::nanoseconds(1));
+        for (auto &priority : pathNs)
+        {
+            priority = referenceNs > priority ? referenceNs - priority : 0;
+        }
+    }
+
+    void TaskScheduler::submitTask(std::shared_ptr<ExecutionContext> context, size_t index)
+    {
+        // 节点提交不需要返回值，走无future、无堆分配的提交路径
+        uint64_t priority = context->priorities[index];
+        Executor &executor = executorFor(*context, index);
+        executor.dispatch([this, context = std::move(context), index]()
+                          { runTask(context, index); },
+                          priority);
+    }
+
+    Executor &TaskScheduler::executorFor(const ExecutionContext &context, size_t index) const
+    {
+        if (ioExecutor_ && context.nodes[index]->getKind() == TaskKind::Io)
+        {
+            return *ioExecutor_;
+        }
+        return *threadPool_;
+    }
+
+    bool TaskScheduler::missesDeadline(const ExecutionContext &context, size_t index) const
+    {
+        if (context.deadline == DataObject::Clock::time_point::max())
+        {
+            return false;
+        }
+        // 有截止时间时优先级即最晚开始时刻（截止时间减去本节点起的剩余关键路径），
+        // 过了这个时刻，整条路径已无法按时完成，应在上游就放弃，而不是等到耗时节点自身超时
+        uint64_t nowNs = static_cast<uint64_t>(DataObject::Clock::now().time_since_epoch() / std::chrono::nanoseconds(1));
+        return nowNs > context.priorities[index];
+    }
+
+    void TaskScheduler::runTask(const std::shared_ptr<ExecutionContext> &context, size_t index)
+    {
+        // 线性链上的节点在同一工作线程上连续执行，刚产生的数据仍在缓存中
+        while (index != kNoTask)
+        {
+            auto &task = context->nodes[index];
+
+            // 输入边条件不满足的节点直接剪枝，不调用处理函数
+            auto pruned = task->checkInputConditions();
+            if (pruned)
             {
-                futures.push_back(threadPool_.enqueue([this, dep]()
+                task->prune(std::move(pruned));
+            }
+            // 已无法按时完成的帧不再执行剩余节点，避免在推理等耗时节点上浪费算力
+            else if (context->cancelled.load(std::memory_order_relaxed) || missesDeadline(*context, index))
+            {
+                if (!context->cancelled.exchange(true, std::memory_order_relaxed))
+                {
+                    LOG.debug("Deadline cannot be met, cancelling frame at task [%s]", task->getName().c_str());
+                }
+                task->cancel();
+            }
+            else
+            {
+                // 其他读取者都已执行完的前驱，其结果移交给本节点独占，任务可以原地修改而无需拷贝
+                const auto &predecessors = context->predecessors[index];
+                for (size_t position = 0; position < predecessors.size(); ++position)
+                {
+                    size_t predecessor = predecessors[position];
+                    task->setInputTransferable(position, predecessor != TaskNode::kInvalidTaskId &&
+                                                             context->pendingConsumers[predecessor].load(std::memory_order_acquire) == 1 &&
+                                                             !context->predecessor(predecessor).isResultShared());
+                }
+
+                // 处理函数被挂起（等待任务实例或批次）时本线程不等待，节点完成后由resumeTask接着推进后继
+                if (!executeTask(context, index))
                 {
-                    try {
-                        executeTask(dep);
-                    } catch (const std::exception& e) {
-                        LOG.error("Exception while executing dependency: %s", e.what());
-                    } catch (...) {
-                        LOG.error("Unknown exception while executing dependency");
-                    }
-                }));
+                    return;
+                }
             }
+
+            index = finishTask(context, index);
         }
+    }
 
-        // 等待所有依赖任务完成
-        for (auto &future : futures)
+    bool TaskScheduler::executeTask(const std::shared_ptr<ExecutionContext> &context, size_t index)
+    {
+        auto &task = context->nodes[index];
+        try
         {
-            try {
-                future.wait();
-            } catch (const std::exception& e) {
-                LOG.error("Exception while waiting for task dependency: %s", e.what());
+            if (!task->executeAsync(executorFor(*context, index), context->priorities[index],
+                                    [this, context, index]()
+                                    { resumeTask(context, index); }))
+            {
+                return false;
             }
+            recordExecutionTime(*context, index);
+        }
+        catch (const std::exception &e)
+        {
+            LOG.error("Exception in task [%s]: %s", task->getName().c_str(), e.what());
         }
+        catch (...)
+        {
+            LOG.error("Unknown exception in task [%s]", task->getName().c_str());
+        }
+        return true;
+    }
+
+    void TaskScheduler::resumeTask(const std::shared_ptr<ExecutionContext> &context, size_t index)
+    {
+        recordExecutionTime(*context, index);
+        runTask(context, finishTask(context, index));
+    }
 
-        try {
-            task->executeOnce();
-        } catch (const std::exception& e) {
-            LOG.error("Exception in task [%s]: %s", task->getId().c_str(), e.what());
-        } catch (...) {
-            LOG.error("Unknown exception in task [%s]", task->getId().c_str());
+    void TaskScheduler::recordExecutionTime(const ExecutionContext &context, size_t index)
+    {
+        const auto &task = context.nodes[index];
+        if (task->getState() == TaskNode::State::Done)
+        {
+            // 更新执行时间的滑动平均，用于判断后续帧能否按时完成
+            TaskTimeEstimates::record(*expectedTimeMs_[task->getId()], task->getExecutionTimeMs());
+        }
+    }
+
+    size_t TaskScheduler::finishTask(const std::shared_ptr<ExecutionContext> &context, size_t index)
+    {
+        // 本节点不再读取输入：最后一个读取某前驱结果的节点释放该结果，
+        // 中间结果不必等到下一帧重置才释放，峰值内存只跟随仍被需要的数据
+        for (size_t predecessor : context->predecessors[index])
+        {
+            if (predecessor != TaskNode::kInvalidTaskId &&
+                context->pendingConsumers[predecessor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                context->predecessor(predecessor).releaseResult();
+            }
+        }
+
+        // 前驱计数归零的后继中，剩余关键路径最长的留在当前线程继续执行，其余的提交到线程池；
+        // 属于另一个执行器的后继总是提交，I/O节点不会占用计算线程，反之亦然
+        size_t next = kNoTask;
+        Executor *current = &executorFor(*context, index);
+        auto dispatch = [this, &context, &next, current](size_t ready)
+        {
+            if (&executorFor(*context, ready) != current)
+            {
+                submitTask(context, ready);
+                return;
+            }
+            if (next == kNoTask)
+            {
+                next = ready;
+                return;
+            }
+            if (context->priorities[ready] < context->priorities[next])
+            {
+                std::swap(next, ready);
+            }
+            submitTask(context, ready);
+        };
+        for (size_t successor : context->successors[index])
+        {
+            if (context->pendingDependencies[successor].fetch_sub(1, std::memory_order_acq_rel) != 1)
+            {
+                continue;
+            }
+
+            // 输入边条件不满足的后继就地剪枝并继续传播，不占用线程池
+            auto &node = context->nodes[successor];
+            auto pruned = node->checkInputConditions();
+            if (pruned && node->prune(std::move(pruned)))
+            {
+                size_t after = finishTask(context, successor);
+                if (after != kNoTask)
+                {
+                    dispatch(after);
+                }
+            }
+            else
+            {
+                dispatch(successor);
+            }
+        }
+
+        if (context->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            std::lock_guard<std::mutex> lock(context->doneMutex);
+            context->doneCondition.notify_all();
         }
+        return next;
     }
 
     void TaskScheduler::clear()
     {
         tasks_.clear();
+        taskIndices_.clear();
+        expectedTimeMs_.clear();
+        compiledOutput_ = TaskNode::kInvalidTaskId;
+        compiledContext_.reset();
     }
     
-    std::unordered_map<std::string, double> TaskScheduler::getTaskExecutionTimes() const
+    std::vector<double> TaskScheduler::getTaskExecutionTimes() const
     {
-        std::unordered_map<std::string, double> executionTimes;
-        for (const auto& pair : tasks_)
+        std::vector<double> executionTimes(tasks_.size(), -1.0);
+        for (size_t id = 0; id < tasks_.size(); ++id)
         {
-            if (pair.second->isExecuted())
+            auto state = tasks_[id]->getState();
+            if (state == TaskNode::State::Done || state == TaskNode::State::Failed)
             {
-                executionTimes[pair.first] = pair.second->getExecutionTimeMs();
+                executionTimes[id] = tasks_[id]->getExecutionTimeMs();
             }
         }
         return executionTimes;
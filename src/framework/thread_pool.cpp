@@ -21,27 +21,27 @@
 namespace GryFlux
 {
 
-    ThreadPool::ThreadPool(size_t numThreads) : stop_(false)
+    ThreadPool::ThreadPool(size_t numThreads, const CpuAffinity &affinity, const ThreadPolicy &policy) : stop_(false)
     {
-        // 确保至少有一个线程，或者使用系统硬件线程数
+        // 未指定线程数时按绑定的CPU数量，不绑定时使用系统硬件线程数，至少一个线程
         if (numThreads == 0)
         {
-            numThreads = std::thread::hardware_concurrency();
-            // 至少一个线程
-            if (numThreads == 0)
-            {
-                numThreads = 1;
-            }
+            numThreads = affinity.defaultThreadCount();
         }
 
         // 创建线程池中的工作线程
         for (size_t i = 0; i < numThreads; ++i)
         {
-            workers_.emplace_back([this, i]
+            workers_.emplace_back([this, i, affinity, policy]
                                   {
+            affinity.applyToCurrentThread();
+            if (!applyThreadPolicy(policy, "ThreadPool worker " + std::to_string(i)).granted()) {
+                policyDenied_++;
+            }
+
             // 线程工作循环
             while (true) {
-                std::function<void()> task;
+                InplaceTask task;
                 {
                     std::unique_lock<std::mutex> lock(queueMutex_);
                     condition_.wait(lock, [this] { 
@@ -52,8 +52,7 @@ namespace GryFlux
                         return;
                     }
                     
-                    task = std::move(tasks_.front());
-                    tasks_.pop();
+                    tasks_.pop_front(task);
                 }
                 
                 // 执行任务
@@ -0,0 +1,189 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#include "framework/work_stealing_thread_pool.h"
+#include "utils/logger.h"
+#include <random>
+#include <stdexcept>
+
+namespace GryFlux
+{
+
+    namespace
+    {
+        // 当前线程所属的线程池及其在池中的序号，用于判断提交是否来自工作线程
+        thread_local const WorkStealingThreadPool *currentPool = nullptr;
+        thread_local size_t currentIndex = 0;
+    }
+
+    WorkStealingThreadPool::WorkStealingThreadPool(size_t numThreads, const CpuAffinity &affinity,
+                                                   const ThreadPolicy &policy)
+        : pendingTasks_(0), nextQueue_(0), idleWorkers_(0), stop_(false)
+    {
+        // 未指定线程数时按绑定的CPU数量，不绑定时使用系统硬件线程数，至少一个线程
+        if (numThreads == 0)
+        {
+            numThreads = affinity.defaultThreadCount();
+        }
+
+        for (size_t i = 0; i < numThreads; ++i)
+        {
+            queues_.emplace_back(std::make_unique<WorkQueue>());
+        }
+
+        // 所有队列创建完成后再启动工作线程，窃取时才能安全访问其他队列
+        for (size_t i = 0; i < numThreads; ++i)
+        {
+            workers_.emplace_back(&WorkStealingThreadPool::workerLoop, this, i, affinity, policy);
+        }
+        LOG.debug("[WorkStealingThreadPool] Initialized with %zu threads", numThreads);
+    }
+
+    WorkStealingThreadPool::~WorkStealingThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            stop_ = true;
+        }
+
+        // 通知所有线程
+        sleepCondition_.notify_all();
+
+        // 等待所有线程完成剩余任务后退出
+        for (std::thread &worker : workers_)
+        {
+            if (worker.joinable())
+            {
+                worker.join();
+            }
+        }
+        LOG.debug("[WorkStealingThreadPool] Destroyed, all %zu threads joined", workers_.size());
+    }
+
+    void WorkStealingThreadPool::post(InplaceTask task, uint64_t priority)
+    {
+        if (stop_)
+        {
+            throw std::runtime_error("enqueue on stopped WorkStealingThreadPool");
+        }
+
+        size_t index = currentPool == this
+                           ? currentIndex
+                           : nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+
+        // 先增加计数再入队，空闲线程看到计数后最多短暂自旋，不会错过任务
+        pendingTasks_.fetch_add(1);
+        {
+            std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+            queues_[index]->tasks.push(std::move(task), priority);
+        }
+
+        if (idleWorkers_.load() > 0)
+        {
+            {
+                std::lock_guard<std::mutex> lock(sleepMutex_);
+            }
+            sleepCondition_.notify_one();
+        }
+    }
+
+    bool WorkStealingThreadPool::popLocal(size_t index, InplaceTask &task)
+    {
+        auto &queue = *queues_[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty())
+        {
+            return false;
+        }
+        // 本地任务LIFO执行，刚产生的数据仍在缓存中
+        queue.tasks.pop_back(task);
+        return true;
+    }
+
+    bool WorkStealingThreadPool::steal(size_t thief, InplaceTask &task)
+    {
+        thread_local std::minstd_rand generator(std::random_device{}());
+
+        const size_t count = queues_.size();
+        const size_t start = generator() % count;
+        for (size_t i = 0; i < count; ++i)
+        {
+            size_t victim = (start + i) % count;
+            if (victim == thief)
+            {
+                continue;
+            }
+
+            auto &queue = *queues_[victim];
+            std::unique_lock<std::mutex> lock(queue.mutex, std::try_to_lock);
+            if (!lock.owns_lock() || queue.tasks.empty())
+            {
+                continue;
+            }
+            // 从队首窃取最早提交的任务
+            queue.tasks.pop_front(task);
+            return true;
+        }
+        return false;
+    }
+
+    void WorkStealingThreadPool::workerLoop(size_t index, CpuAffinity affinity, ThreadPolicy policy)
+    {
+        currentPool = this;
+        currentIndex = index;
+        affinity.applyToCurrentThread();
+        if (!applyThreadPolicy(policy, "WorkStealingThreadPool worker " + std::to_string(index)).granted())
+        {
+            policyDenied_++;
+        }
+
+        while (true)
+        {
+            InplaceTask task;
+            if (popLocal(index, task) || steal(index, task))
+            {
+                pendingTasks_.fetch_sub(1);
+
+                // 执行任务
+                try
+                {
+                    task();
+                }
+                catch (const std::exception &e)
+                {
+                    LOG.error("Exception in thread %zu: %s", index, e.what());
+                }
+                catch (...)
+                {
+                    LOG.error("Unknown exception in thread %zu", index);
+                }
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            idleWorkers_.fetch_add(1);
+            sleepCondition_.wait(lock, [this]
+                                 { return stop_ || pendingTasks_.load() > 0; });
+            idleWorkers_.fetch_sub(1);
+
+            if (stop_ && pendingTasks_.load() == 0)
+            {
+                return;
+            }
+        }
+    }
+
+} // namespace GryFlux
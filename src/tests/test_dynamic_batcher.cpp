@@ -0,0 +1,301 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "framework/dynamic_batcher.h"
+#include "framework/processing_task.h"
+#include "framework/streaming_pipeline.h"
+#include "framework/task_scheduler.h"
+
+using namespace GryFlux;
+
+namespace
+{
+    struct Value : DataObject
+    {
+        explicit Value(int v) : value(v) {}
+        int value;
+    };
+
+    DynamicBatcher::Inputs makeInputs(int v)
+    {
+        return {std::make_shared<Value>(v)};
+    }
+
+    int valueOf(const std::shared_ptr<DataObject> &object)
+    {
+        return std::static_pointer_cast<Value>(object)->value;
+    }
+
+    // 每个输入加1000后原样返回，并记录每个批次的大小
+    struct Recorder
+    {
+        DynamicBatcher::BatchFunction function()
+        {
+            return [this](const std::vector<DynamicBatcher::Inputs> &batch)
+            {
+                batchSizes.push_back(batch.size());
+                std::vector<std::shared_ptr<DataObject>> results;
+                for (const auto &inputs : batch)
+                {
+                    results.push_back(std::make_shared<Value>(valueOf(inputs.front()) + 1000));
+                }
+                return results;
+            };
+        }
+
+        std::vector<size_t> batchSizes; // 批处理函数串行执行，无需加锁
+    };
+
+    // 从count个线程同时调用process，返回各线程取回的结果值，异常记为-1
+    std::vector<int> callConcurrently(DynamicBatcher &batcher, int count)
+    {
+        std::vector<int> results(count, 0);
+        std::vector<std::thread> threads;
+        for (int i = 0; i < count; ++i)
+        {
+            threads.emplace_back([&batcher, &results, i]
+                                 {
+                try
+                {
+                    results[i] = valueOf(batcher.process(makeInputs(i)));
+                }
+                catch (const std::exception &)
+                {
+                    results[i] = -1;
+                } });
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+        return results;
+    }
+
+    // 每帧的输入加1000
+    class BatchedAdder : public BatchProcessingTask
+    {
+    public:
+        explicit BatchedAdder(std::vector<size_t> &batchSizes) : batchSizes_(batchSizes) {}
+
+        std::vector<std::shared_ptr<DataObject>> processBatch(const std::vector<DynamicBatcher::Inputs> &batch) override
+        {
+            batchSizes_.push_back(batch.size());
+            std::vector<std::shared_ptr<DataObject>> results;
+            for (const auto &inputs : batch)
+            {
+                results.push_back(std::make_shared<Value>(valueOf(inputs.front()) + 1000));
+            }
+            return results;
+        }
+
+    private:
+        std::vector<size_t> &batchSizes_;
+    };
+
+    double elapsedMs(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+TEST(DynamicBatcherTest, FullBatchRunsWithoutWaiting)
+{
+    Recorder recorder;
+    DynamicBatcher batcher(recorder.function(), 4, std::chrono::seconds(10));
+
+    auto start = std::chrono::steady_clock::now();
+    auto results = callConcurrently(batcher, 4);
+    EXPECT_LT(elapsedMs(start), 5000.0);
+
+    EXPECT_EQ(recorder.batchSizes, (std::vector<size_t>{4}));
+    auto stats = batcher.getStats();
+    EXPECT_EQ(stats.calls, 4u);
+    EXPECT_EQ(stats.batches, 1u);
+    EXPECT_EQ(stats.fullBatches, 1u);
+    EXPECT_DOUBLE_EQ(stats.hitRate, 1.0);
+}
+
+TEST(DynamicBatcherTest, PartialBatchRunsAfterMaxWait)
+{
+    Recorder recorder;
+    DynamicBatcher batcher(recorder.function(), 4, std::chrono::milliseconds(30));
+
+    auto start = std::chrono::steady_clock::now();
+    auto result = batcher.process(makeInputs(7));
+    EXPECT_GE(elapsedMs(start), 30.0);
+    EXPECT_EQ(valueOf(result), 1007);
+
+    EXPECT_EQ(recorder.batchSizes, (std::vector<size_t>{1}));
+    auto stats = batcher.getStats();
+    EXPECT_EQ(stats.fullBatches, 0u);
+    EXPECT_DOUBLE_EQ(stats.hitRate, 0.0);
+}
+
+TEST(DynamicBatcherTest, SingleCallerDoesNotWait)
+{
+    Recorder recorder;
+    DynamicBatcher batcher(recorder.function(), 4, std::chrono::seconds(10));
+    batcher.addCallers(1);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 3; ++i)
+    {
+        EXPECT_EQ(valueOf(batcher.process(makeInputs(i))), 1000 + i);
+    }
+    EXPECT_LT(elapsedMs(start), 5000.0);
+
+    EXPECT_EQ(recorder.batchSizes, (std::vector<size_t>{1, 1, 1}));
+    EXPECT_DOUBLE_EQ(batcher.getStats().hitRate, 1.0);
+}
+
+TEST(DynamicBatcherTest, ScattersResultsToEachCaller)
+{
+    Recorder recorder;
+    DynamicBatcher batcher(recorder.function(), 3, std::chrono::seconds(10));
+
+    auto results = callConcurrently(batcher, 6);
+    for (int i = 0; i < 6; ++i)
+    {
+        EXPECT_EQ(results[i], 1000 + i);
+    }
+    EXPECT_EQ(recorder.batchSizes, (std::vector<size_t>{3, 3}));
+}
+
+TEST(DynamicBatcherTest, ResultCountMismatchFailsEveryCaller)
+{
+    DynamicBatcher batcher([](const std::vector<DynamicBatcher::Inputs> &)
+                           { return std::vector<std::shared_ptr<DataObject>>{std::make_shared<Value>(0)}; },
+                           3, std::chrono::seconds(10));
+
+    EXPECT_EQ(callConcurrently(batcher, 3), (std::vector<int>{-1, -1, -1}));
+}
+
+TEST(DynamicBatcherTest, ExceptionPropagatesToEveryCaller)
+{
+    std::atomic<int> invocations{0};
+    DynamicBatcher batcher([&invocations](const std::vector<DynamicBatcher::Inputs> &) -> std::vector<std::shared_ptr<DataObject>>
+                           {
+                               invocations++;
+                               throw std::runtime_error("device lost");
+                           },
+                           3, std::chrono::seconds(10));
+
+    EXPECT_EQ(callConcurrently(batcher, 3), (std::vector<int>{-1, -1, -1}));
+    EXPECT_EQ(invocations.load(), 1);
+
+    try
+    {
+        batcher.addCallers(1);
+        batcher.process(makeInputs(0));
+        FAIL() << "expected exception";
+    }
+    catch (const std::runtime_error &e)
+    {
+        EXPECT_STREQ(e.what(), "device lost");
+    }
+}
+
+// 平均批大小只统计已执行的批次，仍在等待的调用不计入
+TEST(DynamicBatcherTest, StatsCountOnlyExecutedBatches)
+{
+    Recorder recorder;
+    DynamicBatcher batcher(recorder.function(), 2, std::chrono::seconds(10));
+    callConcurrently(batcher, 2);
+
+    auto pool = createThreadPool(1);
+    std::shared_ptr<DataObject> result;
+    EXPECT_FALSE(batcher.invoke(makeInputs(9), result, *pool, 0,
+                                [](std::shared_ptr<DataObject>, std::exception_ptr) {}));
+
+    auto stats = batcher.getStats();
+    EXPECT_EQ(stats.calls, 2u);
+    EXPECT_EQ(stats.batches, 1u);
+    EXPECT_DOUBLE_EQ(stats.meanBatchSize, 2.0);
+}
+
+// 调度器提交的调用挂起在批次中，不占用工作线程：单个工作线程上的多个在途帧仍能凑成一个批次
+TEST(DynamicBatcherTest, ScheduledCallsDoNotBlockWorkers)
+{
+    std::vector<size_t> batchSizes;
+    TaskRegistry registry;
+    registry.registerBatchTask<BatchedAdder>("batched", 3, std::chrono::seconds(10), batchSizes);
+
+    auto pool = createThreadPool(1);
+    std::vector<int> results(3, 0);
+    std::vector<std::thread> callers;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 3; ++i)
+    {
+        callers.emplace_back([&, i]
+                             {
+            TaskScheduler scheduler(pool);
+            auto input = std::make_shared<InputNode>("input", std::make_shared<Value>(i));
+            scheduler.addTask(input);
+            scheduler.addTask(std::make_shared<MultiInputTaskNode>(
+                "batched", registry.getProcessFunction("batched"), std::vector<std::shared_ptr<TaskNode>>{input}));
+            auto result = scheduler.execute("batched");
+            results[i] = result ? valueOf(result) : -1; });
+    }
+    for (auto &caller : callers)
+    {
+        caller.join();
+    }
+
+    EXPECT_LT(elapsedMs(start), 5000.0);
+    EXPECT_EQ(results, (std::vector<int>{1000, 1001, 1002}));
+    EXPECT_EQ(batchSizes, (std::vector<size_t>{3}));
+}
+
+// 管道启动时登记在途帧数：只有一个在途帧时批次人数为1，每帧都不等待maxWait
+TEST(DynamicBatcherTest, PipelineRegistersFramesInFlight)
+{
+    std::vector<size_t> batchSizes;
+    TaskRegistry registry;
+    registry.registerBatchTask<BatchedAdder>("batched", 4, std::chrono::seconds(10), batchSizes);
+
+    auto graph = std::make_shared<GraphTemplate>();
+    graph->addInput("input");
+    graph->addTask("batched", registry.getProcessFunction("batched"), {"input"});
+    graph->compile("batched");
+
+    StreamingPipeline pipeline(2, 16, 1);
+    pipeline.setGraphTemplate(graph);
+    pipeline.start();
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<int> results;
+    for (int i = 0; i < 3; ++i)
+    {
+        pipeline.addInput(std::make_shared<Value>(i));
+        std::shared_ptr<DataObject> output;
+        pipeline.getOutput(output);
+        results.push_back(output ? valueOf(output) : -1);
+    }
+    EXPECT_LT(elapsedMs(start), 5000.0);
+    pipeline.stop();
+
+    EXPECT_EQ(results, (std::vector<int>{1000, 1001, 1002}));
+    EXPECT_EQ(batchSizes, (std::vector<size_t>{1, 1, 1}));
+    EXPECT_DOUBLE_EQ(registry.getBatchStats("batched").hitRate, 1.0);
+}
@@ -0,0 +1,272 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "utils/lockfree_queue.h"
+
+namespace
+{
+    template <typename Queue>
+    class LockfreeQueueTest : public ::testing::Test
+    {
+    };
+
+    using QueueTypes = ::testing::Types<mpmc_queue<int>, spsc_queue<int>>;
+    TYPED_TEST_SUITE(LockfreeQueueTest, QueueTypes);
+
+    // 等待线程进入阻塞，再关闭队列
+    void settle()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+}
+
+TYPED_TEST(LockfreeQueueTest, RejectsZeroCapacity)
+{
+    EXPECT_THROW(TypeParam(0), std::runtime_error);
+}
+
+TYPED_TEST(LockfreeQueueTest, TryPushFailsWhenFull)
+{
+    TypeParam queue(2);
+    EXPECT_TRUE(queue.try_push(1));
+    EXPECT_TRUE(queue.try_push(2));
+    EXPECT_FALSE(queue.try_push(3));
+    EXPECT_EQ(queue.size(), 2u);
+
+    int value = 0;
+    EXPECT_TRUE(queue.try_pop(value));
+    EXPECT_EQ(value, 1);
+    EXPECT_TRUE(queue.try_push(3));
+    EXPECT_FALSE(queue.try_push(4));
+}
+
+TYPED_TEST(LockfreeQueueTest, SingleSlotHoldsOneItem)
+{
+    TypeParam queue(1);
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(queue.try_push(i));
+        EXPECT_FALSE(queue.try_push(i + 100));
+        int value = -1;
+        EXPECT_TRUE(queue.try_pop(value));
+        EXPECT_EQ(value, i);
+        EXPECT_FALSE(queue.try_pop(value));
+    }
+}
+
+TYPED_TEST(LockfreeQueueTest, WrapsAroundAtCapacity)
+{
+    TypeParam queue(3);
+    int next = 0;
+    int expected = 0;
+    // 每轮写满再部分读出，读写位置反复越过环形缓冲区末尾
+    for (int round = 0; round < 10; ++round)
+    {
+        while (queue.try_push(next))
+        {
+            next++;
+        }
+        EXPECT_EQ(queue.size(), 3u);
+        for (int i = 0; i < 2; ++i)
+        {
+            int value = -1;
+            ASSERT_TRUE(queue.try_pop(value));
+            EXPECT_EQ(value, expected++);
+        }
+    }
+
+    int values[4] = {};
+    EXPECT_EQ(queue.try_pop_bulk(values, 4), 1u);
+    EXPECT_EQ(values[0], expected);
+    EXPECT_TRUE(queue.empty());
+}
+
+TYPED_TEST(LockfreeQueueTest, PopWaitTimesOutWhenEmpty)
+{
+    TypeParam queue(2);
+    int value = 0;
+    EXPECT_FALSE(queue.pop_wait(value, std::chrono::milliseconds(10)));
+    EXPECT_EQ(queue.pop_wait_bulk(&value, 1, std::chrono::milliseconds(10)), 0u);
+}
+
+TYPED_TEST(LockfreeQueueTest, CloseWakesBlockedConsumer)
+{
+    TypeParam queue(2);
+    std::atomic<bool> result{true};
+    std::thread consumer([&]
+                         {
+        int value = 0;
+        result = queue.pop_wait(value); });
+    settle();
+    queue.close();
+    consumer.join();
+    EXPECT_FALSE(result.load());
+}
+
+TYPED_TEST(LockfreeQueueTest, CloseWakesBlockedProducer)
+{
+    TypeParam queue(1);
+    ASSERT_TRUE(queue.try_push(1));
+    std::atomic<bool> result{true};
+    std::thread producer([&]
+                         { result = queue.push_wait(2); });
+    settle();
+    queue.close();
+    producer.join();
+    EXPECT_FALSE(result.load());
+
+    // 关闭后拒绝入队，已有数据仍可取出
+    EXPECT_FALSE(queue.try_push(3));
+    int value = 0;
+    EXPECT_TRUE(queue.pop_wait(value));
+    EXPECT_EQ(value, 1);
+    EXPECT_FALSE(queue.pop_wait(value));
+}
+
+TYPED_TEST(LockfreeQueueTest, ReopenAcceptsBlockedWaitersAgain)
+{
+    TypeParam queue(1);
+    queue.close();
+    queue.reopen();
+    EXPECT_FALSE(queue.closed());
+
+    // 重新打开后等待者再次阻塞，并由入队正常唤醒
+    std::atomic<int> received{-1};
+    std::thread consumer([&]
+                         {
+        int value = 0;
+        if (queue.pop_wait(value))
+        {
+            received = value;
+        } });
+    settle();
+    EXPECT_EQ(received.load(), -1);
+    EXPECT_TRUE(queue.try_push(7));
+    consumer.join();
+    EXPECT_EQ(received.load(), 7);
+
+    ASSERT_TRUE(queue.try_push(8));
+    std::thread producer([&]
+                         { queue.push_wait(9); });
+    settle();
+    int value = 0;
+    ASSERT_TRUE(queue.pop_wait(value));
+    EXPECT_EQ(value, 8);
+    producer.join();
+    ASSERT_TRUE(queue.pop_wait(value));
+    EXPECT_EQ(value, 9);
+}
+
+TEST(SpscQueueTest, PreservesOrderUnderConcurrency)
+{
+    constexpr int kCount = 200000;
+    spsc_queue<int> queue(16);
+    std::thread producer([&]
+                         {
+        for (int i = 0; i < kCount; ++i)
+        {
+            queue.push_wait(i);
+        }
+        queue.close(); });
+
+    int expected = 0;
+    int value = 0;
+    while (queue.pop_wait(value))
+    {
+        ASSERT_EQ(value, expected++);
+    }
+    producer.join();
+    EXPECT_EQ(expected, kCount);
+}
+
+TEST(MpmcQueueTest, DeliversEveryItemExactlyOnce)
+{
+    constexpr int kProducers = 4;
+    constexpr int kConsumers = 4;
+    constexpr int kPerProducer = 50000;
+    mpmc_queue<int> queue(64);
+
+    std::vector<std::atomic<int>> seen(kProducers * kPerProducer);
+    for (auto &count : seen)
+    {
+        count.store(0);
+    }
+
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < kConsumers; ++c)
+    {
+        consumers.emplace_back([&, c]
+                               {
+            int values[8];
+            while (true)
+            {
+                // 单个与批量出队交替使用
+                size_t count = 0;
+                if (c % 2 == 0)
+                {
+                    count = queue.pop_wait(values[0]) ? 1 : 0;
+                }
+                else
+                {
+                    count = queue.pop_wait_bulk(values, 8, std::chrono::milliseconds(100));
+                    if (count == 0 && queue.closed() && queue.empty())
+                    {
+                        break;
+                    }
+                }
+                if (count == 0 && c % 2 == 0)
+                {
+                    break;
+                }
+                for (size_t i = 0; i < count; ++i)
+                {
+                    seen[values[i]].fetch_add(1, std::memory_order_relaxed);
+                }
+            } });
+    }
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p)
+    {
+        producers.emplace_back([&, p]
+                               {
+            for (int i = 0; i < kPerProducer; ++i)
+            {
+                queue.push_wait(p * kPerProducer + i);
+            } });
+    }
+    for (auto &producer : producers)
+    {
+        producer.join();
+    }
+    queue.close();
+    for (auto &consumer : consumers)
+    {
+        consumer.join();
+    }
+
+    for (size_t i = 0; i < seen.size(); ++i)
+    {
+        ASSERT_EQ(seen[i].load(), 1) << "item " << i;
+    }
+}
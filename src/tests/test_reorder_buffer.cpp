@@ -0,0 +1,196 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "framework/reorder_buffer.h"
+
+using namespace GryFlux;
+
+namespace
+{
+    struct Frame : DataObject
+    {
+    };
+
+    std::shared_ptr<DataObject> makeFrame(uint64_t sequence)
+    {
+        auto frame = std::make_shared<Frame>();
+        frame->setSequence(sequence);
+        return frame;
+    }
+
+    // 记录释放顺序：正常结果为序号，占位为"L3"（Late）、"D3"（Dropped）等
+    class Collector
+    {
+    public:
+        ReorderBuffer::ReleaseCallback callback()
+        {
+            return [this](std::shared_ptr<DataObject> result)
+            {
+                std::string tag = std::to_string(result->getSequence());
+                if (auto placeholder = std::dynamic_pointer_cast<FramePlaceholder>(result))
+                {
+                    static const char *kReasons = "FLDP";
+                    tag = kReasons[static_cast<int>(placeholder->getReason())] + tag;
+                }
+                released.push_back(tag);
+            };
+        }
+
+        std::vector<std::string> released;
+    };
+
+    using Tags = std::vector<std::string>;
+}
+
+TEST(ReorderBufferTest, ReleasesOutOfOrderSubmitsInSequence)
+{
+    Collector out;
+    ReorderBuffer buffer(8, std::chrono::milliseconds(0), LateFramePolicy::Skip, out.callback());
+
+    buffer.submit(2, makeFrame(2));
+    EXPECT_TRUE(out.released.empty());
+    buffer.submit(0, makeFrame(0));
+    EXPECT_EQ(out.released, (Tags{"0"}));
+    buffer.submit(1, makeFrame(1));
+    EXPECT_EQ(out.released, (Tags{"0", "1", "2"}));
+
+    auto stats = buffer.getStats();
+    EXPECT_EQ(stats.released, 3u);
+    EXPECT_EQ(stats.skipped, 0u);
+    EXPECT_EQ(stats.maxBuffered, 2u);
+}
+
+TEST(ReorderBufferTest, WindowOverflowSkipsHead)
+{
+    Collector out;
+    ReorderBuffer buffer(4, std::chrono::milliseconds(0), LateFramePolicy::Placeholder, out.callback());
+
+    for (uint64_t sequence = 1; sequence <= 3; ++sequence)
+    {
+        buffer.submit(sequence, makeFrame(sequence));
+    }
+    EXPECT_TRUE(out.released.empty());
+
+    // 帧4超出窗口[0, 4)，队首帧0被跳过
+    buffer.submit(4, makeFrame(4));
+    EXPECT_EQ(out.released, (Tags{"L0", "1", "2", "3", "4"}));
+
+    auto stats = buffer.getStats();
+    EXPECT_EQ(stats.skipped, 1u);
+    EXPECT_EQ(stats.placeholders, 1u);
+    EXPECT_EQ(stats.released, 4u);
+}
+
+TEST(ReorderBufferTest, PollSkipsHeadAfterTimeout)
+{
+    Collector out;
+    ReorderBuffer buffer(8, std::chrono::milliseconds(20), LateFramePolicy::Placeholder, out.callback());
+
+    buffer.submit(1, makeFrame(1));
+    buffer.poll();
+    EXPECT_TRUE(out.released.empty());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    buffer.poll();
+    EXPECT_EQ(out.released, (Tags{"L0", "1"}));
+}
+
+TEST(ReorderBufferTest, SubmitSkipsHeadAfterTimeoutWithoutPoll)
+{
+    Collector out;
+    ReorderBuffer buffer(64, std::chrono::milliseconds(20), LateFramePolicy::Placeholder, out.callback());
+
+    buffer.submit(1, makeFrame(1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    buffer.submit(2, makeFrame(2));
+    EXPECT_EQ(out.released, (Tags{"L0", "1", "2"}));
+}
+
+TEST(ReorderBufferTest, DropsResultArrivingAfterSkip)
+{
+    Collector out;
+    ReorderBuffer buffer(2, std::chrono::milliseconds(0), LateFramePolicy::Skip, out.callback());
+
+    buffer.submit(1, makeFrame(1));
+    buffer.submit(2, makeFrame(2));
+    EXPECT_EQ(out.released, (Tags{"1", "2"}));
+
+    buffer.submit(0, makeFrame(0));
+    EXPECT_EQ(out.released, (Tags{"1", "2"}));
+
+    auto stats = buffer.getStats();
+    EXPECT_EQ(stats.skipped, 1u);
+    EXPECT_EQ(stats.lateArrivals, 1u);
+}
+
+TEST(ReorderBufferTest, FlushReleasesUpToEndSequence)
+{
+    Collector out;
+    ReorderBuffer buffer(8, std::chrono::milliseconds(0), LateFramePolicy::Placeholder, out.callback());
+
+    buffer.submit(0, makeFrame(0));
+    buffer.submit(2, makeFrame(2));
+    buffer.submit(5, makeFrame(5));
+    buffer.flush(4);
+    EXPECT_EQ(out.released, (Tags{"0", "L1", "2", "L3"}));
+
+    // 帧5不在flush范围内，帧4到达后正常释放
+    buffer.submit(4, makeFrame(4));
+    EXPECT_EQ(out.released, (Tags{"0", "L1", "2", "L3", "4", "5"}));
+
+    buffer.submit(3, makeFrame(3));
+    EXPECT_EQ(buffer.getStats().lateArrivals, 1u);
+}
+
+TEST(ReorderBufferTest, PlaceholderPolicyEmitsFailedFrames)
+{
+    Collector out;
+    ReorderBuffer buffer(8, std::chrono::milliseconds(0), LateFramePolicy::Placeholder, out.callback());
+
+    buffer.submit(0, nullptr, FramePlaceholder::Reason::Dropped);
+    buffer.submit(1, nullptr, FramePlaceholder::Reason::Pruned);
+    buffer.submit(2, nullptr);
+    EXPECT_EQ(out.released, (Tags{"D0", "P1", "F2"}));
+
+    auto stats = buffer.getStats();
+    EXPECT_EQ(stats.dropped, 1u);
+    EXPECT_EQ(stats.pruned, 1u);
+    EXPECT_EQ(stats.failed, 1u);
+    EXPECT_EQ(stats.placeholders, 3u);
+}
+
+TEST(ReorderBufferTest, SkipPolicyEmitsNothingForMissingFrames)
+{
+    Collector out;
+    ReorderBuffer buffer(2, std::chrono::milliseconds(0), LateFramePolicy::Skip, out.callback());
+
+    buffer.submit(0, nullptr, FramePlaceholder::Reason::Dropped);
+    buffer.submit(2, makeFrame(2));
+    buffer.submit(3, makeFrame(3));
+    EXPECT_EQ(out.released, (Tags{"2", "3"}));
+
+    auto stats = buffer.getStats();
+    EXPECT_EQ(stats.dropped, 1u);
+    EXPECT_EQ(stats.skipped, 1u);
+    EXPECT_EQ(stats.placeholders, 0u);
+}
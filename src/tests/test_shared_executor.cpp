@@ -0,0 +1,116 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include "framework/shared_executor.h"
+
+using namespace GryFlux;
+
+namespace
+{
+    // 忙等指定时间，模拟计算任务；按时间而不是迭代次数计，CPU不足时每个配额完成的任务数仍然相近
+    void spinFor(std::chrono::microseconds duration)
+    {
+        auto until = std::chrono::steady_clock::now() + duration;
+        while (std::chrono::steady_clock::now() < until)
+        {
+        }
+    }
+
+    // 持续向份额提交任务：每个任务完成后计数并重新提交自己，直到stop置位
+    struct Load
+    {
+        std::shared_ptr<Executor> share;
+        std::atomic<size_t> completed{0};
+
+        void submit(const std::atomic<bool> &stop)
+        {
+            share->dispatch([this, &stop]()
+                            {
+                spinFor(std::chrono::microseconds(200));
+                if (stop.load())
+                {
+                    return;
+                }
+                completed.fetch_add(1);
+                submit(stop); });
+        }
+    };
+} // namespace
+
+TEST(SharedExecutorTest, SplitsThreadsByWeight)
+{
+    auto shared = SharedExecutor::create(4);
+    std::atomic<bool> stop{false};
+    Load light;
+    Load heavy;
+    light.share = shared->attach(1);
+    heavy.share = shared->attach(3);
+
+    // 每个份额的待执行任务都多于线程数，两个份额始终同时活跃
+    for (int i = 0; i < 8; ++i)
+    {
+        light.submit(stop);
+        heavy.submit(stop);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    stop = true;
+    size_t lightCount = light.completed.load();
+    size_t heavyCount = heavy.completed.load();
+    light.share.reset();
+    heavy.share.reset();
+
+    ASSERT_GT(lightCount, 0u);
+    double ratio = static_cast<double>(heavyCount) / static_cast<double>(lightCount);
+    EXPECT_GT(ratio, 2.0) << "light " << lightCount << ", heavy " << heavyCount;
+    EXPECT_LT(ratio, 4.5) << "light " << lightCount << ", heavy " << heavyCount;
+}
+
+TEST(SharedExecutorTest, IdleSharesLeaveThreadsToActiveOnes)
+{
+    auto shared = SharedExecutor::create(4);
+    auto idle = shared->attach(3);
+    auto active = shared->attach(1);
+
+    std::atomic<size_t> running{0};
+    std::atomic<size_t> peak{0};
+    std::atomic<size_t> done{0};
+    for (int i = 0; i < 32; ++i)
+    {
+        active->dispatch([&]()
+                         {
+            size_t now = running.fetch_add(1) + 1;
+            size_t seen = peak.load();
+            while (now > seen && !peak.compare_exchange_weak(seen, now))
+            {
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            running.fetch_sub(1);
+            done.fetch_add(1); });
+    }
+    while (done.load() < 32)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // 另一个份额没有任务，不计入权重之和，权重为1的份额也可以用满全部线程
+    EXPECT_EQ(peak.load(), shared->getThreadCount());
+}
@@ -0,0 +1,167 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "framework/stage_graph.h"
+
+using namespace GryFlux;
+
+namespace
+{
+    struct Value : DataObject
+    {
+        explicit Value(int v) : value(v) {}
+        int value;
+    };
+
+    // 处理函数在闸门打开前停住，让后续帧在阶段队列中排队
+    struct Gate
+    {
+        void pass()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            ++entered;
+            condition.notify_all();
+            condition.wait(lock, [this]
+                           { return open; });
+        }
+
+        void waitEntered(int count)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this, count]
+                           { return entered >= count; });
+        }
+
+        void release()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            open = true;
+            condition.notify_all();
+        }
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        int entered = 0;
+        bool open = false;
+    };
+
+    // 记录输出回调收到的帧
+    struct Outputs
+    {
+        void add(uint64_t sequence, StageGraph::FrameStatus status)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            sequences.push_back(sequence);
+            statuses.push_back(status);
+        }
+
+        std::mutex mutex;
+        std::vector<uint64_t> sequences;
+        std::vector<StageGraph::FrameStatus> statuses;
+    };
+
+    std::shared_ptr<DataObject> frame(uint64_t sequence, DataObject::Clock::time_point deadline)
+    {
+        auto value = std::make_shared<Value>(static_cast<int>(sequence));
+        value->setSequence(sequence);
+        if (deadline != DataObject::Clock::time_point::max())
+        {
+            value->setDeadline(deadline);
+        }
+        return value;
+    }
+
+    GraphTemplate singleStage(std::function<void()> body)
+    {
+        GraphTemplate graph;
+        graph.addInput("input");
+        graph.addTask("stage", [body](const std::vector<std::shared_ptr<DataObject>> &inputs)
+                      {
+            body();
+            return inputs.front(); },
+                      {"input"});
+        graph.compile("stage");
+        return graph;
+    }
+} // namespace
+
+// 阶段队列按截止时间出队，截止时间相同（或都没有截止时间）的帧先进先出
+TEST(StageGraphTest, QueuePopsEarliestDeadlineFirst)
+{
+    auto gate = std::make_shared<Gate>();
+    Outputs outputs;
+    StageGraph::StageConfig config;
+    config.queueCapacity = 8;
+    StageGraph graph(singleStage([gate]
+                                 { gate->pass(); }),
+                     {{"stage", config}},
+                     [&outputs](uint64_t sequence, std::shared_ptr<DataObject>, StageGraph::FrameStatus status)
+                     { outputs.add(sequence, status); });
+    graph.start();
+
+    auto now = DataObject::Clock::now();
+    auto never = DataObject::Clock::time_point::max();
+    graph.push(frame(0, never));
+    gate->waitEntered(1);
+    graph.push(frame(1, never));
+    graph.push(frame(2, now + std::chrono::hours(3)));
+    graph.push(frame(3, now + std::chrono::hours(1)));
+    graph.push(frame(4, never));
+    graph.push(frame(5, now + std::chrono::hours(2)));
+    graph.push(frame(6, now + std::chrono::hours(1)));
+
+    gate->release();
+    graph.stop();
+    EXPECT_EQ(outputs.sequences, (std::vector<uint64_t>{0, 3, 6, 5, 2, 1, 4}));
+}
+
+// 已知耗时的阶段之前，剩余关键路径超出截止时间的帧被丢弃，不执行该阶段
+TEST(StageGraphTest, DropsFrameThatCannotMeetDeadline)
+{
+    Outputs outputs;
+    int calls = 0;
+    StageGraph graph(singleStage([&calls]
+                                 {
+                                     ++calls;
+                                     std::this_thread::sleep_for(std::chrono::milliseconds(20)); }),
+                     {},
+                     [&outputs](uint64_t sequence, std::shared_ptr<DataObject>, StageGraph::FrameStatus status)
+                     { outputs.add(sequence, status); });
+    graph.start();
+
+    // 第一帧完成后阶段才有耗时估计
+    graph.push(frame(0, DataObject::Clock::now() + std::chrono::seconds(10)));
+    while (graph.getCompletedFrames() < 1)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    graph.push(frame(1, DataObject::Clock::now() + std::chrono::milliseconds(5)));
+    graph.stop();
+
+    ASSERT_EQ(outputs.statuses.size(), 2u);
+    EXPECT_EQ(outputs.statuses[0], StageGraph::FrameStatus::Completed);
+    EXPECT_EQ(outputs.statuses[1], StageGraph::FrameStatus::Dropped);
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(graph.getStageStats().front().dropped, 1u);
+}
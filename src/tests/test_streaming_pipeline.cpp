@@ -0,0 +1,198 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "framework/streaming_pipeline.h"
+
+using namespace GryFlux;
+
+namespace
+{
+    struct Value : DataObject
+    {
+        explicit Value(int v) : value(v) {}
+        int value;
+    };
+
+    int valueOf(const std::shared_ptr<DataObject> &object)
+    {
+        return object ? std::static_pointer_cast<Value>(object)->value : -1;
+    }
+
+    // 处理节点在闸门打开前停住，用来让输入队列保持满
+    struct Gate
+    {
+        void pass()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            ++entered;
+            condition.notify_all();
+            condition.wait(lock, [this]
+                           { return open; });
+        }
+
+        void waitEntered(int count)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this, count]
+                           { return entered >= count; });
+        }
+
+        void release()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            open = true;
+            condition.notify_all();
+        }
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        int entered = 0;
+        bool open = false;
+    };
+
+    std::shared_ptr<GraphTemplate> gatedGraph(const std::shared_ptr<Gate> &gate)
+    {
+        auto graph = std::make_shared<GraphTemplate>();
+        graph->addInput("input");
+        graph->addTask("gated", [gate](const std::vector<std::shared_ptr<DataObject>> &inputs)
+                       {
+            gate->pass();
+            return std::make_shared<Value>(valueOf(inputs.front())); },
+                       {"input"});
+        graph->compile("gated");
+        return graph;
+    }
+
+    // 取出所有输出直到流关闭
+    std::vector<int> drain(StreamingPipeline &pipeline)
+    {
+        std::vector<int> values;
+        std::shared_ptr<DataObject> output;
+        for (pipeline.getOutput(output); output; pipeline.getOutput(output))
+        {
+            values.push_back(valueOf(output));
+        }
+        return values;
+    }
+} // namespace
+
+// 队列满时多个生产者同时等待空位，处理线程取走输入后依次入队，帧序号连续
+TEST(StreamingPipelineTest, BlockedProducersResumeWhenInputIsTaken)
+{
+    auto gate = std::make_shared<Gate>();
+    StreamingPipeline pipeline(2, 1, 1);
+    pipeline.setGraphTemplate(gatedGraph(gate));
+    pipeline.start();
+
+    // 第一帧停在处理节点中，第二帧占满输入队列
+    ASSERT_TRUE(pipeline.addInput(std::make_shared<Value>(0)));
+    gate->waitEntered(1);
+    ASSERT_TRUE(pipeline.addInput(std::make_shared<Value>(1)));
+
+    std::vector<std::thread> producers;
+    std::atomic<int> accepted{0};
+    for (int i = 0; i < 3; ++i)
+    {
+        producers.emplace_back([&pipeline, &accepted, i]
+                               {
+            if (pipeline.addInput(std::make_shared<Value>(10 + i)))
+            {
+                accepted++;
+            } });
+    }
+    // 等待空位时不持有输入锁，三个生产者能同时进入等待
+    auto limit = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (pipeline.getInputQueueStats().blocked < 3 && std::chrono::steady_clock::now() < limit)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(pipeline.getInputQueueStats().blocked, 3u);
+
+    gate->release();
+    for (auto &producer : producers)
+    {
+        producer.join();
+    }
+    pipeline.stop();
+
+    EXPECT_EQ(accepted.load(), 3);
+    auto values = drain(pipeline);
+    ASSERT_EQ(values.size(), 5u);
+    EXPECT_EQ(values[0], 0);
+    EXPECT_EQ(values[1], 1);
+}
+
+// stop()唤醒等待空位的生产者，已入队的帧照常输出，输出流随后关闭
+TEST(StreamingPipelineTest, StopWakesBlockedProducer)
+{
+    auto gate = std::make_shared<Gate>();
+    StreamingPipeline pipeline(2, 1, 1);
+    pipeline.setGraphTemplate(gatedGraph(gate));
+    pipeline.start();
+
+    ASSERT_TRUE(pipeline.addInput(std::make_shared<Value>(0)));
+    gate->waitEntered(1);
+    ASSERT_TRUE(pipeline.addInput(std::make_shared<Value>(1)));
+
+    std::atomic<bool> done{false};
+    bool result = true;
+    std::thread producer([&]
+                         {
+        result = pipeline.addInput(std::make_shared<Value>(2));
+        done = true; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(done.load());
+
+    std::thread stopper([&pipeline]
+                        { pipeline.stop(); });
+    producer.join();
+    EXPECT_FALSE(result);
+
+    gate->release();
+    stopper.join();
+    EXPECT_EQ(drain(pipeline), (std::vector<int>{0, 1}));
+}
+
+// KeepLatest替换掉的帧按丢弃交付，按序输出跳过它们，只输出正在处理的帧与最新的帧
+TEST(StreamingPipelineTest, KeepLatestDropsReplacedFrames)
+{
+    auto gate = std::make_shared<Gate>();
+    StreamingPipeline pipeline(2, 1, 1);
+    pipeline.setGraphTemplate(gatedGraph(gate));
+    pipeline.setInputOverflowPolicy(InputOverflowPolicy::KeepLatest);
+    pipeline.start();
+
+    ASSERT_TRUE(pipeline.addInput(std::make_shared<Value>(0)));
+    gate->waitEntered(1);
+    for (int i = 1; i <= 4; ++i)
+    {
+        ASSERT_TRUE(pipeline.addInput(std::make_shared<Value>(i)));
+    }
+    EXPECT_EQ(pipeline.getInputQueueStats().replaced, 3u);
+
+    gate->release();
+    pipeline.stop();
+    EXPECT_EQ(drain(pipeline), (std::vector<int>{0, 4}));
+}
@@ -0,0 +1,175 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "framework/task_node.h"
+
+using namespace GryFlux;
+
+namespace
+{
+    struct Value : DataObject
+    {
+        explicit Value(int v) : value(v) {}
+        int value;
+    };
+
+    int valueOf(const std::shared_ptr<DataObject> &object)
+    {
+        return object ? std::static_pointer_cast<Value>(object)->value : -1;
+    }
+
+    // 处理函数抛出异常的节点
+    class ThrowingNode : public TaskNode
+    {
+    public:
+        ThrowingNode() : TaskNode("throwing") {}
+
+        std::shared_ptr<DataObject> execute() override
+        {
+            throw std::runtime_error("failed");
+        }
+    };
+} // namespace
+
+// 多个线程同时调用executeOnce时处理函数只执行一次；读取方看到Done后即可读到完整的结果
+TEST(TaskNodeTest, ExecutesOnceAndPublishesResult)
+{
+    auto input = std::make_shared<InputNode>("input", std::make_shared<Value>(41));
+    std::atomic<int> calls{0};
+    auto node = std::make_shared<MultiInputTaskNode>(
+        "node", [&calls](const std::vector<std::shared_ptr<DataObject>> &inputs)
+        {
+            calls++;
+            return std::make_shared<Value>(valueOf(inputs.front()) + 1); },
+        std::vector<std::shared_ptr<TaskNode>>{input});
+    EXPECT_TRUE(node->isReady());
+
+    std::atomic<bool> go{false};
+    std::vector<int> seen(4, 0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([&, i]
+                             {
+            while (!go.load())
+            {
+            }
+            node->executeOnce();
+            // 没有抢到执行权的线程立即返回，等待执行的线程发布结果
+            while (node->getState() != TaskNode::State::Done)
+            {
+                std::this_thread::yield();
+            }
+            seen[i] = valueOf(node->getResult()); });
+    }
+    go = true;
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(calls.load(), 1);
+    EXPECT_EQ(seen, (std::vector<int>(4, 42)));
+    EXPECT_TRUE(node->isExecuted());
+}
+
+// 执行期间状态为Running，结果尚不可读
+TEST(TaskNodeTest, ResultIsHiddenWhileRunning)
+{
+    auto input = std::make_shared<InputNode>("input", std::make_shared<Value>(1));
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool entered = false;
+    bool release = false;
+    auto node = std::make_shared<MultiInputTaskNode>(
+        "node", [&](const std::vector<std::shared_ptr<DataObject>> &inputs)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            entered = true;
+            condition.notify_all();
+            condition.wait(lock, [&]
+                           { return release; });
+            return inputs.front(); },
+        std::vector<std::shared_ptr<TaskNode>>{input});
+
+    std::thread worker([&node]
+                       { node->executeOnce(); });
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [&]
+                       { return entered; });
+    }
+    EXPECT_EQ(node->getState(), TaskNode::State::Running);
+    EXPECT_FALSE(node->isExecuted());
+    EXPECT_EQ(node->getResult(), nullptr);
+    EXPECT_FALSE(node->cancel());
+    EXPECT_FALSE(node->prune(TaskOutcome::skip()));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        release = true;
+        condition.notify_all();
+    }
+    worker.join();
+    EXPECT_EQ(node->getState(), TaskNode::State::Done);
+    EXPECT_EQ(valueOf(node->getResult()), 1);
+}
+
+// Pending只能进入一种终止状态：取消、剪枝或执行（成功或失败），reset回到Pending
+TEST(TaskNodeTest, StateTransitions)
+{
+    auto input = std::make_shared<InputNode>("input", std::make_shared<Value>(7));
+    auto node = std::make_shared<MultiInputTaskNode>(
+        "node", [](const std::vector<std::shared_ptr<DataObject>> &inputs)
+        { return inputs.front(); },
+        std::vector<std::shared_ptr<TaskNode>>{input});
+    EXPECT_EQ(node->getState(), TaskNode::State::Pending);
+
+    EXPECT_TRUE(node->cancel());
+    EXPECT_EQ(node->getState(), TaskNode::State::Cancelled);
+    EXPECT_TRUE(node->isExecuted());
+    EXPECT_EQ(node->getResult(), nullptr);
+    EXPECT_FALSE(node->cancel());
+    node->executeOnce();
+    EXPECT_EQ(node->getState(), TaskNode::State::Cancelled);
+
+    node->reset();
+    EXPECT_EQ(node->getState(), TaskNode::State::Pending);
+    auto outcome = TaskOutcome::empty();
+    EXPECT_TRUE(node->prune(outcome));
+    EXPECT_EQ(node->getState(), TaskNode::State::Skipped);
+    EXPECT_EQ(node->getResult(), outcome);
+
+    node->reset();
+    node->executeOnce();
+    EXPECT_EQ(node->getState(), TaskNode::State::Done);
+    EXPECT_EQ(valueOf(node->getResult()), 7);
+    EXPECT_FALSE(node->cancel());
+
+    ThrowingNode throwing;
+    EXPECT_THROW(throwing.executeOnce(), std::runtime_error);
+    EXPECT_EQ(throwing.getState(), TaskNode::State::Failed);
+    EXPECT_TRUE(throwing.isExecuted());
+    EXPECT_EQ(throwing.getResult(), nullptr);
+}
@@ -0,0 +1,731 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <sys/resource.h>
+#include "framework/pipeline_builder.h"
+#include "framework/processing_task.h"
+#include "framework/task_scheduler.h"
+
+using namespace GryFlux;
+
+namespace
+{
+    struct Value : DataObject
+    {
+        explicit Value(int v) : value(v) {}
+        int value;
+    };
+
+    int valueOf(const std::shared_ptr<DataObject> &object)
+    {
+        return object ? std::static_pointer_cast<Value>(object)->value : -1;
+    }
+
+    // 计数达到目标后放行等待者；等待超时说明等待期间其他节点无法执行
+    struct Latch
+    {
+        explicit Latch(int target) : target(target) {}
+
+        void countDown()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++count;
+            condition.notify_all();
+        }
+
+        bool wait()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            return condition.wait_for(lock, std::chrono::seconds(2), [this]
+                                      { return count >= target; });
+        }
+
+        const int target;
+        int count = 0;
+        std::mutex mutex;
+        std::condition_variable condition;
+    };
+
+    // 首次调用一直占用实例，直到所有帧的其他分支都执行完毕
+    class GatedTask : public ProcessingTask
+    {
+    public:
+        GatedTask(std::shared_ptr<Latch> latch, std::shared_ptr<std::atomic<int>> active,
+                  std::shared_ptr<std::atomic<int>> peak)
+            : latch_(std::move(latch)), active_(std::move(active)), peak_(std::move(peak)) {}
+
+        std::shared_ptr<DataObject> process(const std::vector<std::shared_ptr<DataObject>> &inputs) override
+        {
+            int now = active_->fetch_add(1) + 1;
+            int previous = peak_->load();
+            while (now > previous && !peak_->compare_exchange_weak(previous, now))
+            {
+            }
+            bool released = latch_->wait();
+            active_->fetch_sub(1);
+            return released ? std::make_shared<Value>(valueOf(inputs.front()) + 1) : nullptr;
+        }
+
+    private:
+        std::shared_ptr<Latch> latch_;
+        std::shared_ptr<std::atomic<int>> active_;
+        std::shared_ptr<std::atomic<int>> peak_;
+    };
+
+    // 以takeInput取得输入并加上delta后作为输出
+    class AddInPlace : public ProcessingTask
+    {
+    public:
+        explicit AddInPlace(int delta) : delta_(delta) {}
+
+        std::shared_ptr<DataObject> process(const std::vector<std::shared_ptr<DataObject>> &inputs) override
+        {
+            auto value = takeInput<Value>(inputs, 0);
+            value->value += delta_;
+            return value;
+        }
+
+    private:
+        int delta_;
+    };
+
+    std::shared_ptr<DataObject> passThrough(const std::vector<std::shared_ptr<DataObject>> &inputs)
+    {
+        return inputs.front();
+    }
+
+    // 把两个输入的值合成一个新对象：第一个值×1000加第二个值
+    std::shared_ptr<DataObject> combine(const std::vector<std::shared_ptr<DataObject>> &inputs)
+    {
+        return std::make_shared<Value>(valueOf(inputs[0]) * 1000 + valueOf(inputs[1]));
+    }
+
+    // 每帧一张图：input -> gated -> after -> output，input -> side -> output
+    // gated分支更长，就绪时优先于side执行；side执行时对latch计数
+    std::shared_ptr<TaskScheduler> buildFrame(const std::shared_ptr<Executor> &pool, TaskRegistry &registry,
+                                              const std::shared_ptr<Latch> &latch, int value)
+    {
+        auto scheduler = std::make_shared<TaskScheduler>(pool);
+        auto input = std::make_shared<InputNode>("input", std::make_shared<Value>(value));
+        auto gated = std::make_shared<MultiInputTaskNode>(
+            "gated", registry.getProcessFunction("gated"), std::vector<std::shared_ptr<TaskNode>>{input});
+        auto after = std::make_shared<MultiInputTaskNode>(
+            "after", [](const std::vector<std::shared_ptr<DataObject>> &inputs)
+            { return inputs.front(); },
+            std::vector<std::shared_ptr<TaskNode>>{gated});
+        auto side = std::make_shared<MultiInputTaskNode>(
+            "side", [latch](const std::vector<std::shared_ptr<DataObject>> &inputs)
+            {
+                latch->countDown();
+                return inputs.front(); },
+            std::vector<std::shared_ptr<TaskNode>>{input});
+        auto output = std::make_shared<MultiInputTaskNode>(
+            "output", [](const std::vector<std::shared_ptr<DataObject>> &inputs)
+            { return inputs.front(); },
+            std::vector<std::shared_ptr<TaskNode>>{after, side});
+        for (const auto &node : std::vector<std::shared_ptr<TaskNode>>{input, gated, after, side, output})
+        {
+            scheduler->addTask(node);
+        }
+        return scheduler;
+    }
+
+    // 多个在途帧在同一线程池上并发执行，返回各帧的输出值，失败的帧为-1
+    std::vector<int> runFrames(TaskConcurrency concurrency, int frames, size_t threads, int &peak)
+    {
+        auto latch = std::make_shared<Latch>(frames);
+        auto active = std::make_shared<std::atomic<int>>(0);
+        auto peakActive = std::make_shared<std::atomic<int>>(0);
+        TaskRegistry registry;
+        registry.registerTask<GatedTask>("gated", concurrency, latch, active, peakActive);
+
+        auto pool = createThreadPool(threads);
+        std::vector<int> results(frames, 0);
+        std::vector<std::thread> callers;
+        for (int i = 0; i < frames; ++i)
+        {
+            callers.emplace_back([&, i]
+                                 {
+                auto scheduler = buildFrame(pool, registry, latch, i * 10);
+                results[i] = valueOf(scheduler->execute("output")); });
+        }
+        for (auto &caller : callers)
+        {
+            caller.join();
+        }
+        peak = peakActive->load();
+        return results;
+    }
+
+    // 单个节点的帧：节点执行时把自己的名称追加到order
+    std::shared_ptr<TaskScheduler> singleNodeFrame(const std::shared_ptr<Executor> &pool, const std::string &name,
+                                                   std::vector<std::string> &order)
+    {
+        auto scheduler = std::make_shared<TaskScheduler>(pool);
+        auto input = std::make_shared<InputNode>("input", std::make_shared<Value>(1));
+        auto node = std::make_shared<MultiInputTaskNode>(
+            name, [&order, name](const std::vector<std::shared_ptr<DataObject>> &inputs)
+            {
+                order.push_back(name);
+                return inputs.front(); },
+            std::vector<std::shared_ptr<TaskNode>>{input});
+        scheduler->addTask(input);
+        scheduler->addTask(node);
+        return scheduler;
+    }
+
+    // 占住单线程池的工作线程，按顺序启动各帧并等它们的就绪节点都进入队列后再放行，
+    // 之后的执行顺序只由队列中的优先级决定
+    void runQueued(Executor &pool, const std::vector<std::pair<std::shared_ptr<TaskScheduler>, std::string>> &frames)
+    {
+        auto latch = std::make_shared<Latch>(1);
+        std::atomic<bool> blocked{false};
+        pool.dispatch([latch, &blocked]
+                      {
+            blocked = true;
+            latch->wait(); });
+        while (!blocked.load())
+        {
+            std::this_thread::yield();
+        }
+
+        std::vector<std::thread> callers;
+        for (const auto &frame : frames)
+        {
+            callers.emplace_back([&frame]
+                                 { frame.first->execute(frame.second); });
+            while (pool.getTaskCount() < callers.size())
+            {
+                std::this_thread::yield();
+            }
+        }
+        latch->countDown();
+        for (auto &caller : callers)
+        {
+            caller.join();
+        }
+    }
+} // namespace
+
+// 串行任务的实例被占用时，其他帧对它的调用被挂起，工作线程继续执行其他就绪节点
+TEST(TaskSchedulerTest, SerialTaskDoesNotBlockWorkers)
+{
+    int peak = 0;
+    auto results = runFrames(TaskConcurrency::serial(), 3, 2, peak);
+    EXPECT_EQ(results, (std::vector<int>{1, 11, 21}));
+    EXPECT_EQ(peak, 1);
+}
+
+TEST(TaskSchedulerTest, ReplicatedTaskBoundsConcurrentInstances)
+{
+    int peak = 0;
+    auto results = runFrames(TaskConcurrency::replicated(2), 4, 3, peak);
+    EXPECT_EQ(results, (std::vector<int>{1, 11, 21, 31}));
+    EXPECT_LE(peak, 2);
+}
+
+// 输入节点参与读取者计数：唯一的读取者直接取得输入数据，不再拷贝
+TEST(TaskSchedulerTest, TakeInputReusesInputOfSoleReader)
+{
+    TaskRegistry registry;
+    registry.registerTask<AddInPlace>("add", TaskConcurrency::serial(), 1);
+
+    auto data = std::make_shared<Value>(5);
+    TaskScheduler scheduler(createThreadPool(1));
+    auto input = std::make_shared<InputNode>("input", data);
+    scheduler.addTask(input);
+    scheduler.addTask(std::make_shared<MultiInputTaskNode>(
+        "add", registry.getProcessFunction("add"), std::vector<std::shared_ptr<TaskNode>>{input}));
+
+    auto result = scheduler.execute("add");
+    EXPECT_EQ(result.get(), data.get());
+    EXPECT_EQ(valueOf(result), 6);
+}
+
+// 输入还有其他读取者时takeInput返回拷贝，其他读取者看到的仍是原值
+TEST(TaskSchedulerTest, TakeInputCopiesWhileOthersStillRead)
+{
+    auto adder = std::make_shared<AddInPlace>(1);
+    auto data = std::make_shared<Value>(5);
+    TaskScheduler scheduler(createThreadPool(1));
+    auto input = std::make_shared<InputNode>("input", data);
+    auto add = std::make_shared<MultiInputTaskNode>("add", adder->getProcessFunction(),
+                                                    std::vector<std::shared_ptr<TaskNode>>{input});
+    auto read = std::make_shared<MultiInputTaskNode>("read", combine, std::vector<std::shared_ptr<TaskNode>>{input, add});
+    for (const auto &node : std::vector<std::shared_ptr<TaskNode>>{input, add, read})
+    {
+        scheduler.addTask(node);
+    }
+
+    // add先于read执行，此时input仍有read这个读取者
+    EXPECT_EQ(valueOf(scheduler.execute("read")), 5006);
+    EXPECT_EQ(data->value, 5);
+}
+
+// 原样返回输入的节点，其结果仍与上游共享，后继不能把它当作独占输入原地修改
+TEST(TaskSchedulerTest, PassThroughResultIsNotTransferred)
+{
+    auto adder = std::make_shared<AddInPlace>(100);
+    auto data = std::make_shared<Value>(5);
+    TaskScheduler scheduler(createThreadPool(1));
+    auto input = std::make_shared<InputNode>("input", data);
+    auto forward = std::make_shared<MultiInputTaskNode>("forward", passThrough,
+                                                        std::vector<std::shared_ptr<TaskNode>>{input});
+    auto add = std::make_shared<MultiInputTaskNode>("add", adder->getProcessFunction(),
+                                                    std::vector<std::shared_ptr<TaskNode>>{forward});
+    auto read = std::make_shared<MultiInputTaskNode>("read", combine, std::vector<std::shared_ptr<TaskNode>>{input, add});
+    for (const auto &node : std::vector<std::shared_ptr<TaskNode>>{input, forward, add, read})
+    {
+        scheduler.addTask(node);
+    }
+
+    EXPECT_EQ(valueOf(scheduler.execute("read")), 5105);
+    EXPECT_EQ(data->value, 5);
+}
+
+// 不是由调度器调用时没有移交所有权，takeInput总是拷贝
+TEST(TaskSchedulerTest, TakeInputCopiesOutsideScheduler)
+{
+    AddInPlace adder(1);
+    auto data = std::make_shared<Value>(5);
+    auto result = adder.process({data});
+    EXPECT_NE(result.get(), data.get());
+    EXPECT_EQ(data->value, 5);
+}
+
+// enqueue以提交时刻为优先级：先于截止时间更晚的节点执行，而不是排在所有带优先级的任务之后
+TEST(TaskSchedulerTest, EnqueuedTaskRunsBeforeLaterDeadlines)
+{
+    auto pool = createThreadPool(1);
+    auto latch = std::make_shared<Latch>(1);
+    std::mutex mutex;
+    std::vector<std::string> order;
+    auto record = [&](const std::string &name)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        order.push_back(name);
+    };
+
+    // 占住唯一的工作线程，让后面两个任务同时在队列中等待
+    pool->dispatch([latch]
+                   { latch->wait(); });
+    uint64_t later = Executor::currentPriority() + std::chrono::nanoseconds(std::chrono::hours(1)).count();
+    pool->dispatch([&]
+                   { record("later"); },
+                   later);
+    auto enqueued = pool->enqueue([&]
+                                  { record("enqueued"); });
+    latch->countDown();
+
+    enqueued.wait();
+    pool.reset();
+    EXPECT_EQ(order, (std::vector<std::string>{"enqueued", "later"}));
+}
+
+// 重建计算图后沿用节点的执行时间估计：已知耗时20ms的节点在截止时间只剩1ms的帧中直接被取消
+TEST(TaskSchedulerTest, ResetKeepsExecutionTimeEstimates)
+{
+    PipelineBuilder builder(createThreadPool(1));
+    auto build = [&builder]
+    {
+        builder.reset();
+        auto input = builder.addInput("input", std::make_shared<Value>(1));
+        builder.addTask("slow", [](const std::vector<std::shared_ptr<DataObject>> &inputs)
+                        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            return inputs.front(); },
+                        {input});
+    };
+
+    build();
+    EXPECT_EQ(valueOf(builder.execute("slow")), 1);
+
+    build();
+    builder.getScheduler()->setDeadline(DataObject::Clock::now() + std::chrono::milliseconds(1));
+    EXPECT_EQ(builder.execute("slow"), nullptr);
+    EXPECT_TRUE(builder.getScheduler()->wasCancelled());
+}
+
+// 共享同一份估计的调度器（同一计算图的多个实例）互相可见对方记录的执行时间
+TEST(TaskSchedulerTest, SchedulersShareExecutionTimeEstimates)
+{
+    auto pool = createThreadPool(1);
+    auto estimates = std::make_shared<TaskTimeEstimates>();
+    auto build = [&]
+    {
+        auto scheduler = std::make_shared<TaskScheduler>(pool);
+        scheduler->setTimeEstimates(estimates);
+        auto input = std::make_shared<InputNode>("input", std::make_shared<Value>(1));
+        auto slow = std::make_shared<MultiInputTaskNode>(
+            "slow", [](const std::vector<std::shared_ptr<DataObject>> &inputs)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                return inputs.front(); },
+            std::vector<std::shared_ptr<TaskNode>>{input});
+        scheduler->addTask(input);
+        scheduler->addTask(slow);
+        return scheduler;
+    };
+
+    auto first = build();
+    auto second = build();
+    EXPECT_EQ(valueOf(first->execute("slow")), 1);
+    EXPECT_GE(estimates->slot("slow").load(), 10.0);
+
+    second->setDeadline(DataObject::Clock::now() + std::chrono::milliseconds(1));
+    EXPECT_EQ(second->execute("slow"), nullptr);
+    EXPECT_TRUE(second->wasCancelled());
+}
+
+// I/O节点在I/O执行器的线程上执行，计算节点留在计算线程池，I/O线程按请求的调度策略运行
+TEST(TaskSchedulerTest, IoNodesRunOnIoExecutor)
+{
+    auto pool = createThreadPool(1);
+    auto ioPool = createIoThreadPool(1, CpuAffinity::any(), ThreadPolicy::niceValue(5));
+    ASSERT_TRUE(ioPool->isThreadPolicyGranted());
+    auto computeThread = pool->enqueue([]
+                                       { return std::this_thread::get_id(); })
+                             .get();
+    auto ioThread = ioPool->enqueue([]
+                                    { return std::this_thread::get_id(); })
+                        .get();
+    auto ioNice = ioPool->enqueue([]
+                                  { return getpriority(PRIO_PROCESS, 0); })
+                      .get();
+    EXPECT_EQ(ioNice, 5);
+
+    std::thread::id computeRan;
+    std::thread::id ioRan;
+    auto scheduler = std::make_shared<TaskScheduler>(pool);
+    scheduler->setIoExecutor(ioPool);
+    auto input = std::make_shared<InputNode>("input", std::make_shared<Value>(1));
+    auto compute = std::make_shared<MultiInputTaskNode>(
+        "compute", [&computeRan](const std::vector<std::shared_ptr<DataObject>> &inputs)
+        {
+            computeRan = std::this_thread::get_id();
+            return inputs.front(); },
+        std::vector<std::shared_ptr<TaskNode>>{input});
+    auto sink = std::make_shared<MultiInputTaskNode>(
+        "sink", [&ioRan](const std::vector<std::shared_ptr<DataObject>> &inputs)
+        {
+            ioRan = std::this_thread::get_id();
+            return inputs.front(); },
+        std::vector<std::shared_ptr<TaskNode>>{compute});
+    sink->setKind(TaskKind::Io);
+    for (const auto &node : std::vector<std::shared_ptr<TaskNode>>{input, compute, sink})
+    {
+        scheduler->addTask(node);
+    }
+
+    EXPECT_EQ(valueOf(scheduler->execute("sink")), 1);
+    EXPECT_EQ(computeRan, computeThread);
+    EXPECT_EQ(ioRan, ioThread);
+}
+
+// 计算图深度远大于线程数时也能完成：节点在前驱全部完成后才提交，工作线程从不等待其他节点
+TEST(TaskSchedulerTest, DeepGraphCompletesOnSingleThread)
+{
+    auto scheduler = std::make_shared<TaskScheduler>(createThreadPool(1));
+    auto input = std::make_shared<InputNode>("input", std::make_shared<Value>(0));
+    scheduler->addTask(input);
+
+    auto increment = [](const std::vector<std::shared_ptr<DataObject>> &inputs)
+    { return std::make_shared<Value>(valueOf(inputs.front()) + 1); };
+    std::shared_ptr<TaskNode> last = input;
+    for (int i = 0; i < 64; ++i)
+    {
+        last = std::make_shared<MultiInputTaskNode>("chain" + std::to_string(i), increment,
+                                                    std::vector<std::shared_ptr<TaskNode>>{last});
+        scheduler->addTask(last);
+    }
+
+    // 链的末端扇出到多个分支再汇合
+    std::vector<std::shared_ptr<TaskNode>> branches;
+    for (int i = 0; i < 16; ++i)
+    {
+        branches.push_back(std::make_shared<MultiInputTaskNode>(
+            "branch" + std::to_string(i), increment, std::vector<std::shared_ptr<TaskNode>>{last}));
+        scheduler->addTask(branches.back());
+    }
+    auto sum = std::make_shared<MultiInputTaskNode>(
+        "sum", [](const std::vector<std::shared_ptr<DataObject>> &inputs)
+        {
+            int total = 0;
+            for (const auto &input : inputs)
+            {
+                total += valueOf(input);
+            }
+            return std::make_shared<Value>(total); },
+        branches);
+    scheduler->addTask(sum);
+
+    EXPECT_EQ(valueOf(scheduler->execute("sum")), 16 * 65);
+}
+
+// 任务序号按添加顺序稠密分配，同名节点替换原节点并沿用其序号；执行时间按序号索引，未执行的为负值
+TEST(TaskSchedulerTest, AssignsDenseTaskIds)
+{
+    TaskScheduler scheduler(createThreadPool(1));
+    auto input = std::make_shared<InputNode>("input", std::make_shared<Value>(1));
+    auto used = std::make_shared<MultiInputTaskNode>("used", passThrough, std::vector<std::shared_ptr<TaskNode>>{input});
+    auto unused = std::make_shared<MultiInputTaskNode>("unused", passThrough,
+                                                       std::vector<std::shared_ptr<TaskNode>>{input});
+    EXPECT_EQ(scheduler.addTask(input), 0u);
+    EXPECT_EQ(scheduler.addTask(used), 1u);
+    EXPECT_EQ(scheduler.addTask(unused), 2u);
+
+    auto replacement = std::make_shared<MultiInputTaskNode>("used", combine,
+                                                            std::vector<std::shared_ptr<TaskNode>>{input, input});
+    EXPECT_EQ(scheduler.addTask(replacement), 1u);
+    EXPECT_EQ(replacement->getId(), 1u);
+    EXPECT_EQ(scheduler.getTaskCount(), 3u);
+    EXPECT_EQ(scheduler.getTask(1), replacement);
+    EXPECT_EQ(scheduler.findTaskId("unused"), 2u);
+    EXPECT_EQ(scheduler.findTaskId("missing"), TaskNode::kInvalidTaskId);
+
+    EXPECT_EQ(valueOf(scheduler.execute(1)), 1001);
+    auto times = scheduler.getTaskExecutionTimes();
+    ASSERT_EQ(times.size(), 3u);
+    EXPECT_GE(times[0], 0.0);
+    EXPECT_GE(times[1], 0.0);
+    EXPECT_LT(times[2], 0.0);
+}
+
+// 线性链上每个节点新就绪的唯一后继在同一工作线程上直接执行；
+// 有多个后继时只有一个留在当前线程，其余提交到线程池由其他线程执行
+TEST(TaskSchedulerTest, InlinesFirstReadySuccessor)
+{
+    auto pool = createThreadPool(4);
+    std::mutex mutex;
+    std::unordered_map<std::string, std::thread::id> threads;
+    auto recorded = [&](const std::string &name, std::chrono::milliseconds duration)
+    {
+        return [&, name, duration](const std::vector<std::shared_ptr<DataObject>> &inputs)
+        {
+            std::this_thread::sleep_for(duration);
+            std::lock_guard<std::mutex> lock(mutex);
+            threads[name] = std::this_thread::get_id();
+            return inputs.front();
+        };
+    };
+
+    TaskScheduler chain(pool);
+    std::shared_ptr<TaskNode> last = std::make_shared<InputNode>("input", std::make_shared<Value>(1));
+    chain.addTask(last);
+    for (const char *name : {"a", "b", "c", "d"})
+    {
+        last = std::make_shared<MultiInputTaskNode>(name, recorded(name, std::chrono::milliseconds(0)),
+                                                    std::vector<std::shared_ptr<TaskNode>>{last});
+        chain.addTask(last);
+    }
+    EXPECT_EQ(valueOf(chain.execute("d")), 1);
+    EXPECT_EQ(threads["b"], threads["a"]);
+    EXPECT_EQ(threads["c"], threads["a"]);
+    EXPECT_EQ(threads["d"], threads["a"]);
+
+    // 两个分支各耗时20ms：留在当前线程的分支执行期间，另一个分支已由其他线程开始执行
+    TaskScheduler fork(pool);
+    auto input = std::make_shared<InputNode>("input", std::make_shared<Value>(1));
+    auto root = std::make_shared<MultiInputTaskNode>("root", recorded("root", std::chrono::milliseconds(0)),
+                                                     std::vector<std::shared_ptr<TaskNode>>{input});
+    auto left = std::make_shared<MultiInputTaskNode>("left", recorded("left", std::chrono::milliseconds(20)),
+                                                     std::vector<std::shared_ptr<TaskNode>>{root});
+    auto right = std::make_shared<MultiInputTaskNode>("right", recorded("right", std::chrono::milliseconds(20)),
+                                                      std::vector<std::shared_ptr<TaskNode>>{root});
+    auto join = std::make_shared<MultiInputTaskNode>("join", combine, std::vector<std::shared_ptr<TaskNode>>{left, right});
+    for (const auto &node : std::vector<std::shared_ptr<TaskNode>>{input, root, left, right, join})
+    {
+        fork.addTask(node);
+    }
+    EXPECT_EQ(valueOf(fork.execute("join")), 1001);
+    EXPECT_NE(threads["left"], threads["right"]);
+    EXPECT_TRUE(threads["left"] == threads["root"] || threads["right"] == threads["root"]);
+}
+
+// 中间结果在最后一个读取者执行完后立即释放：任一节点执行时只有它的输入仍然存活，
+// 执行结束后只剩输出节点的结果
+TEST(TaskSchedulerTest, ReleasesIntermediateResultsAfterLastReader)
+{
+    struct Tracked : Value
+    {
+        Tracked(int v, std::atomic<int> &live) : Value(v), live(live) { live++; }
+        ~Tracked() override { live--; }
+        std::atomic<int> &live;
+    };
+
+    std::atomic<int> live{0};
+    std::mutex mutex;
+    std::unordered_map<std::string, int> liveAtStart;
+    auto step = [&](const std::string &name)
+    {
+        return [&, name](const std::vector<std::shared_ptr<DataObject>> &inputs)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                liveAtStart[name] = live.load();
+            }
+            int sum = 0;
+            for (const auto &input : inputs)
+            {
+                sum += valueOf(input);
+            }
+            return std::make_shared<Tracked>(sum, live);
+        };
+    };
+
+    // input -> a -> b -> c，input同时被c读取：input存活到c执行完
+    TaskScheduler scheduler(createThreadPool(2));
+    auto input = std::make_shared<InputNode>("input", std::make_shared<Tracked>(1, live));
+    auto a = std::make_shared<MultiInputTaskNode>("a", step("a"), std::vector<std::shared_ptr<TaskNode>>{input});
+    auto b = std::make_shared<MultiInputTaskNode>("b", step("b"), std::vector<std::shared_ptr<TaskNode>>{a});
+    auto c = std::make_shared<MultiInputTaskNode>("c", step("c"), std::vector<std::shared_ptr<TaskNode>>{b, input});
+    for (const auto &node : std::vector<std::shared_ptr<TaskNode>>{input, a, b, c})
+    {
+        scheduler.addTask(node);
+    }
+
+    auto result = scheduler.execute("c");
+    EXPECT_EQ(valueOf(result), 2);
+    EXPECT_EQ(liveAtStart["a"], 1); // input
+    EXPECT_EQ(liveAtStart["b"], 2); // input、a的结果
+    EXPECT_EQ(liveAtStart["c"], 2); // input、b的结果，a的结果已在b执行完后释放
+    EXPECT_EQ(live.load(), 1);
+    EXPECT_EQ(a->getResult(), nullptr);
+    EXPECT_EQ(b->getResult(), nullptr);
+    EXPECT_EQ(input->getResult(), nullptr);
+    EXPECT_EQ(c->getResult(), result);
+}
+
+// 条件边：检测节点没有结果时输出Empty，只接受正常结果的画框节点被剪枝、不被调用，
+// 接受Empty的输出节点直接输出原图；处理函数失败时按OnError边进入错误分支
+TEST(TaskSchedulerTest, ConditionalEdgesPruneAndRoute)
+{
+    std::atomic<int> drawCalls{0};
+    std::atomic<int> errorCalls{0};
+    TaskNode::State drawState = TaskNode::State::Pending;
+    auto run = [&](int value)
+    {
+        TaskScheduler scheduler(createThreadPool(2));
+        auto input = std::make_shared<InputNode>("input", std::make_shared<Value>(value));
+        auto detect = std::make_shared<MultiInputTaskNode>(
+            "detect", [](const std::vector<std::shared_ptr<DataObject>> &inputs) -> std::shared_ptr<DataObject>
+            {
+                int v = valueOf(inputs.front());
+                if (v < 0)
+                {
+                    throw std::runtime_error("detector failed");
+                }
+                if (v == 0)
+                {
+                    return TaskOutcome::empty();
+                }
+                return std::make_shared<Value>(v * 10); },
+            std::vector<std::shared_ptr<TaskNode>>{input});
+        auto draw = std::make_shared<MultiInputTaskNode>(
+            "draw", [&drawCalls](const std::vector<std::shared_ptr<DataObject>> &inputs)
+            {
+                drawCalls++;
+                return std::make_shared<Value>(valueOf(inputs[1]) + 1); },
+            std::vector<std::shared_ptr<TaskNode>>{input, detect});
+        auto onError = std::make_shared<MultiInputTaskNode>(
+            "onError", [&errorCalls](const std::vector<std::shared_ptr<DataObject>> &inputs)
+            {
+                errorCalls++;
+                EXPECT_TRUE(inputs.front()->is<TaskOutcome>());
+                return std::make_shared<Value>(-1); },
+            std::vector<std::shared_ptr<TaskNode>>{detect}, std::vector<EdgeCondition>{EdgeCondition::OnError});
+        // 有画框结果时输出画框结果，检测为空时输出原图
+        auto send = std::make_shared<MultiInputTaskNode>(
+            "send", [](const std::vector<std::shared_ptr<DataObject>> &inputs)
+            { return inputs[1]->is<TaskOutcome>() ? inputs[0] : inputs[1]; },
+            std::vector<std::shared_ptr<TaskNode>>{input, draw},
+            std::vector<EdgeCondition>{EdgeCondition::OnValue, EdgeCondition::OnValue | EdgeCondition::OnEmpty});
+        for (const auto &node : std::vector<std::shared_ptr<TaskNode>>{input, detect, draw, onError, send})
+        {
+            scheduler.addTask(node);
+        }
+        auto output = scheduler.addTask(std::make_shared<MultiInputTaskNode>(
+            "output", [](const std::vector<std::shared_ptr<DataObject>> &inputs)
+            { return inputs[0]->is<TaskOutcome>() ? inputs[1] : inputs[0]; },
+            std::vector<std::shared_ptr<TaskNode>>{send, onError},
+            std::vector<EdgeCondition>{EdgeCondition::Always, EdgeCondition::Always}));
+        auto result = scheduler.execute(output);
+        drawState = draw->getState();
+        return result;
+    };
+
+    // 有检测结果：画框并输出，错误分支被剪枝
+    EXPECT_EQ(valueOf(run(3)), 31);
+    EXPECT_EQ(drawState, TaskNode::State::Done);
+    EXPECT_EQ(drawCalls.load(), 1);
+    EXPECT_EQ(errorCalls.load(), 0);
+
+    // 检测为空：不画框，输出原图
+    EXPECT_EQ(valueOf(run(0)), 0);
+    EXPECT_EQ(drawState, TaskNode::State::Skipped);
+    EXPECT_EQ(drawCalls.load(), 1);
+    EXPECT_EQ(errorCalls.load(), 0);
+
+    // 检测失败：画框与发送被剪枝，错误分支执行
+    EXPECT_EQ(valueOf(run(-5)), -1);
+    EXPECT_EQ(drawState, TaskNode::State::Skipped);
+    EXPECT_EQ(drawCalls.load(), 1);
+    EXPECT_EQ(errorCalls.load(), 1);
+}
+
+// 在途帧之间按最晚开始时刻排序：后开始的帧剩余关键路径长得多时，先于早开始的帧执行
+TEST(TaskSchedulerTest, LongerCriticalPathRunsFirstAcrossFrames)
+{
+    auto pool = createThreadPool(1);
+    auto estimates = std::make_shared<TaskTimeEstimates>();
+    estimates->slot("slow").store(50.0);
+
+    std::vector<std::string> order;
+    auto fast = singleNodeFrame(pool, "fast", order);
+    auto slow = singleNodeFrame(pool, "slow", order);
+    fast->setTimeEstimates(estimates);
+    slow->setTimeEstimates(estimates);
+    runQueued(*pool, {{fast, "fast"}, {slow, "slow"}});
+
+    EXPECT_EQ(order, (std::vector<std::string>{"slow", "fast"}));
+}
+
+// 截止时间较早的帧即使后提交也先执行
+TEST(TaskSchedulerTest, EarlierDeadlineRunsFirstAcrossFrames)
+{
+    auto pool = createThreadPool(1);
+    std::vector<std::string> order;
+    auto late = singleNodeFrame(pool, "late", order);
+    auto early = singleNodeFrame(pool, "early", order);
+    const auto now = DataObject::Clock::now();
+    late->setDeadline(now + std::chrono::hours(2));
+    early->setDeadline(now + std::chrono::hours(1));
+    runQueued(*pool, {{late, "late"}, {early, "early"}});
+
+    EXPECT_EQ(order, (std::vector<std::string>{"early", "late"}));
+}
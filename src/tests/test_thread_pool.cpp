@@ -0,0 +1,134 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+#include "framework/executor.h"
+
+using namespace GryFlux;
+
+namespace
+{
+    // 统计counting置位期间所有线程的堆分配次数
+    std::atomic<bool> counting{false};
+    std::atomic<size_t> allocations{0};
+
+    // 提交rounds轮、每轮count个任务，每轮等全部执行完再提交下一轮，返回最后一轮期间的堆分配次数。
+    // 每轮先占住所有工作线程，任务全部入队后才放行，各轮的队列峰值深度相同，第一轮之后任务槽已足够
+    size_t allocationsPerRound(Executor &pool, size_t count, int rounds)
+    {
+        std::atomic<size_t> done{0};
+        std::atomic<bool> release{false};
+        size_t measured = 0;
+        for (int round = 0; round < rounds; ++round)
+        {
+            bool last = round == rounds - 1;
+            done = 0;
+            release = false;
+            allocations = 0;
+            counting = last;
+            for (size_t i = 0; i < pool.getThreadCount(); ++i)
+            {
+                pool.dispatch([&release]
+                              {
+                    while (!release.load())
+                    {
+                        std::this_thread::yield();
+                    } });
+            }
+            for (size_t i = 0; i < count; ++i)
+            {
+                pool.dispatch([&done]
+                              { done.fetch_add(1); });
+            }
+            release = true;
+            while (done.load() < count)
+            {
+                std::this_thread::yield();
+            }
+            counting = false;
+            measured = allocations.load();
+        }
+        return measured;
+    }
+} // namespace
+
+void *operator new(std::size_t size)
+{
+    if (counting.load(std::memory_order_relaxed))
+    {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void *p = std::malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+// 不内联，避免编译器把内联后的free与operator new配对检查
+[[gnu::noinline]] void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+// 预热后dispatch不再分配内存：可调用对象存放在任务槽内，任务槽循环复用
+TEST(ThreadPoolTest, DispatchDoesNotAllocateAfterWarmUp)
+{
+    for (auto type : {ThreadPoolType::SharedQueue, ThreadPoolType::WorkStealing})
+    {
+        auto pool = createThreadPool(2, type);
+        EXPECT_EQ(allocationsPerRound(*pool, 200, 4), 0u);
+    }
+}
+
+// 带优先级的任务按数值从小到大执行，同优先级先进先出，未指定优先级的任务最后按提交顺序执行
+TEST(ThreadPoolTest, TaskQueueOrdersByPriority)
+{
+    TaskQueue queue;
+    std::vector<int> order;
+    auto push = [&](int id, uint64_t priority)
+    {
+        queue.push(InplaceTask([&order, id]
+                               { order.push_back(id); }),
+                   priority);
+    };
+    push(1, TaskQueue::kNoPriority);
+    push(2, 30);
+    push(3, 10);
+    push(4, TaskQueue::kNoPriority);
+    push(5, 20);
+    push(6, 10);
+
+    while (!queue.empty())
+    {
+        InplaceTask task;
+        queue.pop_front(task);
+        task();
+    }
+    EXPECT_EQ(order, (std::vector<int>{3, 6, 5, 2, 1, 4}));
+}
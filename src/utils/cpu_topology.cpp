@@ -0,0 +1,232 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#include "utils/cpu_topology.h"
+#include "utils/logger.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace GryFlux
+{
+
+    namespace
+    {
+        const char *kCpuSysfsRoot = "/sys/devices/system/cpu/";
+
+        // 读取sysfs中只有一个整数的文件，读取失败返回-1
+        long readSysfsValue(const std::string &path)
+        {
+            std::ifstream file(path);
+            long value = -1;
+            if (!(file >> value))
+            {
+                return -1;
+            }
+            return value;
+        }
+
+        // 解析 "0-3,6,8-9" 形式的CPU列表
+        std::vector<int> parseCpuList(const std::string &text)
+        {
+            std::vector<int> cpus;
+            std::stringstream stream(text);
+            std::string range;
+            while (std::getline(stream, range, ','))
+            {
+                int first = 0;
+                int last = 0;
+                if (std::sscanf(range.c_str(), "%d-%d", &first, &last) == 2)
+                {
+                    for (int cpu = first; cpu <= last; ++cpu)
+                    {
+                        cpus.push_back(cpu);
+                    }
+                }
+                else if (std::sscanf(range.c_str(), "%d", &first) == 1)
+                {
+                    cpus.push_back(first);
+                }
+            }
+            return cpus;
+        }
+
+        // 把连续的CPU编号合并为 "0-3,6" 形式
+        std::string formatCpuList(const std::vector<int> &cpus)
+        {
+            std::string text;
+            for (size_t i = 0; i < cpus.size();)
+            {
+                size_t j = i;
+                while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1)
+                {
+                    ++j;
+                }
+                if (!text.empty())
+                {
+                    text += ",";
+                }
+                text += std::to_string(cpus[i]);
+                if (j > i)
+                {
+                    text += "-" + std::to_string(cpus[j]);
+                }
+                i = j + 1;
+            }
+            return text;
+        }
+    }
+
+    const CpuTopology &CpuTopology::getInstance()
+    {
+        static CpuTopology topology;
+        return topology;
+    }
+
+    CpuTopology::CpuTopology()
+    {
+        std::ifstream online(std::string(kCpuSysfsRoot) + "online");
+        std::string text;
+        if (std::getline(online, text))
+        {
+            cpus_ = parseCpuList(text);
+        }
+        if (cpus_.empty())
+        {
+            unsigned count = std::max(1u, std::thread::hardware_concurrency());
+            for (unsigned cpu = 0; cpu < count; ++cpu)
+            {
+                cpus_.push_back(static_cast<int>(cpu));
+            }
+        }
+
+        // 优先使用调度器的cpu_capacity，任一核心缺失时改用最大频率
+        std::vector<long> performance;
+        for (const char *source : {"/cpu_capacity", "/cpufreq/cpuinfo_max_freq"})
+        {
+            performance.clear();
+            for (int cpu : cpus_)
+            {
+                long value = readSysfsValue(kCpuSysfsRoot + std::string("cpu") + std::to_string(cpu) + source);
+                if (value <= 0)
+                {
+                    break;
+                }
+                performance.push_back(value);
+            }
+            if (performance.size() == cpus_.size())
+            {
+                break;
+            }
+        }
+
+        if (performance.size() == cpus_.size())
+        {
+            long lowest = *std::min_element(performance.begin(), performance.end());
+            for (size_t i = 0; i < cpus_.size(); ++i)
+            {
+                (performance[i] > lowest ? bigCores_ : littleCores_).push_back(cpus_[i]);
+            }
+        }
+        heterogeneous_ = !bigCores_.empty() && !littleCores_.empty();
+        if (!heterogeneous_)
+        {
+            bigCores_ = cpus_;
+            littleCores_ = cpus_;
+        }
+    }
+
+    std::string CpuTopology::describe() const
+    {
+        if (!heterogeneous_)
+        {
+            return "homogeneous: " + formatCpuList(cpus_);
+        }
+        return "big: " + formatCpuList(bigCores_) + ", little: " + formatCpuList(littleCores_);
+    }
+
+    std::vector<int> CpuAffinity::resolve() const
+    {
+        switch (mode)
+        {
+        case Mode::BigCores:
+            return CpuTopology::getInstance().getBigCores();
+        case Mode::LittleCores:
+            return CpuTopology::getInstance().getLittleCores();
+        case Mode::CpuList:
+            return cpus;
+        default:
+            return {};
+        }
+    }
+
+    size_t CpuAffinity::defaultThreadCount() const
+    {
+        size_t count = mode == Mode::Any ? 0 : resolve().size();
+        if (count == 0)
+        {
+            count = std::max(1u, std::thread::hardware_concurrency());
+        }
+        return count;
+    }
+
+    bool CpuAffinity::applyToCurrentThread() const
+    {
+        if (mode == Mode::Any)
+        {
+            return true;
+        }
+
+        auto list = resolve();
+        if (list.empty())
+        {
+            LOG.warning("[CpuAffinity] Empty CPU list, affinity not changed");
+            return false;
+        }
+
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : list)
+        {
+            if (cpu >= 0 && cpu < CPU_SETSIZE)
+            {
+                CPU_SET(cpu, &set);
+            }
+        }
+        int error = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (error != 0)
+        {
+            LOG.warning("[CpuAffinity] Failed to bind thread to CPUs %s: %s",
+                        formatCpuList(list).c_str(), std::strerror(error));
+            return false;
+        }
+        return true;
+#else
+        LOG.warning("[CpuAffinity] CPU affinity is not supported on this platform");
+        return false;
+#endif
+    }
+
+} // namespace GryFlux
@@ -0,0 +1,120 @@
+/*************************************************************************************************************************
+ * Copyright 2025 Grifcc
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************************************************************/
+#include "utils/thread_priority.h"
+#include "utils/logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace GryFlux
+{
+
+    std::string ThreadPolicy::describe() const
+    {
+        std::string text;
+        switch (scheduler)
+        {
+        case Scheduler::Fifo:
+            text = "SCHED_FIFO:" + std::to_string(priority);
+            break;
+        case Scheduler::RoundRobin:
+            text = "SCHED_RR:" + std::to_string(priority);
+            break;
+        default:
+            text = "default";
+            break;
+        }
+        if (nice)
+        {
+            text += " nice=" + std::to_string(*nice);
+        }
+        if (lockMemory)
+        {
+            text += " mlockall";
+        }
+        return text;
+    }
+
+    ThreadPolicyResult applyThreadPolicy(const ThreadPolicy &policy, const std::string &owner)
+    {
+        ThreadPolicyResult result;
+        if (policy.isDefault())
+        {
+            return result;
+        }
+
+        auto fail = [&result](const char *what, int error)
+        {
+            if (!result.error.empty())
+            {
+                result.error += "; ";
+            }
+            result.error += std::string(what) + ": " + std::strerror(error);
+        };
+
+#ifdef __linux__
+        if (policy.scheduler != ThreadPolicy::Scheduler::Default)
+        {
+            int scheduler = policy.scheduler == ThreadPolicy::Scheduler::Fifo ? SCHED_FIFO : SCHED_RR;
+            sched_param param{};
+            param.sched_priority = std::clamp(policy.priority, sched_get_priority_min(scheduler),
+                                              sched_get_priority_max(scheduler));
+            int error = pthread_setschedparam(pthread_self(), scheduler, &param);
+            if (error != 0)
+            {
+                result.schedulerGranted = false;
+                fail("scheduler", error);
+            }
+        }
+
+        // Linux下按线程ID设置的nice值只作用于该线程
+        if (policy.nice && setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), *policy.nice) != 0)
+        {
+            result.niceGranted = false;
+            fail("nice", errno);
+        }
+
+        if (policy.lockMemory && mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+        {
+            result.memoryLocked = false;
+            fail("mlockall", errno);
+        }
+#else
+        result.schedulerGranted = policy.scheduler == ThreadPolicy::Scheduler::Default;
+        result.niceGranted = !policy.nice;
+        result.memoryLocked = !policy.lockMemory;
+        result.error = "thread policy is not supported on this platform";
+#endif
+
+        if (result.granted())
+        {
+            LOG.debug("[ThreadPolicy] %s: %s granted", owner.c_str(), policy.describe().c_str());
+        }
+        else
+        {
+            LOG.warning("[ThreadPolicy] %s: %s not fully granted (%s)", owner.c_str(), policy.describe().c_str(),
+                        result.error.c_str());
+        }
+        return result;
+    }
+
+} // namespace GryFlux